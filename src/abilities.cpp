@@ -0,0 +1,132 @@
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include "abilities.h"
+#include "intern.h"
+#include "logger.h"
+
+namespace { // file-local helpers and aliases
+    using std::string;
+    using std::vector;
+    using json = nlohmann::json;
+
+    // Pool IDs are the AbilityIds
+    StringPool& registry() {
+        static StringPool instance;
+        return instance;
+    }
+
+    uint32_t typeBit(Type type) {
+        return uint32_t{1} << static_cast<size_t>(type);
+    }
+} // namespace
+
+AbilityId internAbility(std::string_view name) {
+    const StringPool::Id id = registry().intern(name);
+    if (id > UINT16_MAX) {
+        throw std::runtime_error("Too many distinct abilities to intern: " + string(name));
+    }
+    return static_cast<AbilityId>(id);
+}
+
+AbilityList internAbilities(const vector<string>& names) {
+    if (names.size() > kMaxAbilities) {
+        throw std::invalid_argument("More than " + std::to_string(kMaxAbilities) + " abilities, starting with " + names.front());
+    }
+    AbilityList ids;
+    for (const auto& name : names) ids.push_back(internAbility(name));
+    return ids;
+}
+
+std::string_view abilityName(AbilityId id) {
+    const StringPool& abilities = registry();
+    if (id >= abilities.size()) return "???";
+    return abilities.view(id);
+}
+
+AbilityList::AbilityList(std::initializer_list<std::string_view> names) {
+    if (names.size() > kMaxAbilities) {
+        throw std::invalid_argument("More than " + std::to_string(kMaxAbilities) + " abilities, starting with " + string(*names.begin()));
+    }
+    for (const auto name : names) push_back(internAbility(name));
+}
+
+void AbilityEffects::set(std::string_view ability, const AbilityEffect& effect) {
+    const AbilityId id = internAbility(ability);
+    if (id >= effects_.size()) effects_.resize(id + 1);
+    effects_[id] = effect;
+}
+
+double AbilityEffects::apply(Type attacker, double effectiveness, const AbilityList& abilities) const {
+    const uint32_t attackerBit = typeBit(attacker);
+
+    // Evaluate potential immunities
+    for (const AbilityId id : abilities) {
+        if (id >= effects_.size()) continue;
+        const AbilityEffect& effect = effects_[id];
+        if ((effect.immuneTo & attackerBit) || (effect.immuneUnlessSuperEffective && effectiveness <= 1.0)) return 0.0;
+    }
+
+    // Evaluate other modifiers
+    for (const AbilityId id : abilities) {
+        if (id >= effects_.size()) continue;
+        const AbilityEffect& effect = effects_[id];
+        if (effect.multipliedTypes & attackerBit) return effectiveness * effect.multiplier[static_cast<size_t>(attacker)];
+        if (effect.scalesSuperEffective && effectiveness > 1.0) return effectiveness * effect.superEffectiveMultiplier;
+    }
+
+    return effectiveness;
+}
+
+AbilityEffects loadAbilityEffects(const string& path) {
+    Logger::info("Loading ability effects from: " + path);
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open ability effects file: " + path);
+    }
+
+    json j;
+    try {
+        file >> j;
+    } catch (const json::exception& ex) {
+        throw std::runtime_error(string("Failed to parse ability effects JSON: ") + ex.what());
+    }
+    if (!j.is_object()) {
+        throw std::runtime_error("Invalid ability effects format: expected an object keyed by ability name");
+    }
+
+    AbilityEffects effects;
+    for (const auto& [ability, entry] : j.items()) {
+        if (!entry.is_object()) {
+            throw std::runtime_error("Invalid ability effect for " + ability);
+        }
+
+        AbilityEffect effect;
+        try {
+            if (entry.contains("immuneTo")) {
+                for (const auto& type : entry.at("immuneTo")) {
+                    effect.immuneTo |= typeBit(stringToType(type.get<string>()));
+                }
+            }
+            if (entry.contains("immuneUnlessSuperEffective")) {
+                effect.immuneUnlessSuperEffective = entry.at("immuneUnlessSuperEffective").get<bool>();
+            }
+            if (entry.contains("multipliers")) {
+                for (const auto& [typeName, multiplier] : entry.at("multipliers").items()) {
+                    const Type type = stringToType(typeName);
+                    effect.multipliedTypes |= typeBit(type);
+                    effect.multiplier[static_cast<size_t>(type)] = multiplier.get<double>();
+                }
+            }
+            if (entry.contains("superEffectiveMultiplier")) {
+                effect.scalesSuperEffective = true;
+                effect.superEffectiveMultiplier = entry.at("superEffectiveMultiplier").get<double>();
+            }
+        } catch (const std::exception& ex) {
+            throw std::runtime_error("Invalid ability effect for " + ability + ": " + ex.what());
+        }
+        effects.set(ability, effect);
+    }
+
+    return effects;
+}
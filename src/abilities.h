@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "types.h"
+
+// Process-wide ability name <-> ID interning, so ability checks compare integers. Names are
+// kept in a StringPool arena (see intern.h), so the views abilityName returns never dangle.
+// Names match exactly (case-sensitive), as written in the data files.
+AbilityId internAbility(std::string_view name);
+// Throws std::invalid_argument for more than kMaxAbilities names
+AbilityList internAbilities(const std::vector<std::string>& names);
+std::string_view abilityName(AbilityId id);
+
+// What one ability does to incoming attacks, compiled into per-attacking-type masks
+struct AbilityEffect {
+    uint32_t immuneTo = 0;                       // bit per attacking type
+    bool immuneUnlessSuperEffective = false;     // immune to every hit of 1.0x or less
+    uint32_t multipliedTypes = 0;                // bit per attacking type with a multiplier entry
+    std::array<double, NUM_TYPES> multiplier{};  // indexed by attacking type
+    bool scalesSuperEffective = false;           // multiplies > 1.0x hits of types without an entry
+    double superEffectiveMultiplier = 1.0;
+};
+
+// Effects of every known ability, indexed by AbilityId. Abilities without an entry do nothing.
+class AbilityEffects {
+public:
+    void set(std::string_view ability, const AbilityEffect& effect);
+
+    // Applies the defender's abilities to a type-chart multiplier. Assumes the defender uses
+    // the ability that helps most: any immunity wins, otherwise the first ability that
+    // modifies this hit decides it.
+    double apply(Type attacker, double effectiveness, const AbilityList& abilities) const;
+
+    // Every entry by AbilityId; IDs past the end and entries never set do nothing
+    const std::vector<AbilityEffect>& byId() const { return effects_; }
+
+private:
+    std::vector<AbilityEffect> effects_;
+};
+
+/*
+ * Loads ability effects from a JSON file.
+ * Expected JSON structure:
+ * {
+ *   "Levitate": { "immuneTo": ["Ground"] },
+ *   "Wonder Guard": { "immuneUnlessSuperEffective": true },
+ *   "Thick Fat": { "multipliers": { "Fire": 0.5, "Ice": 0.5 } },
+ *   "Filter": { "superEffectiveMultiplier": 0.75 },
+ *   ...
+ * }
+ */
+AbilityEffects loadAbilityEffects(const std::string& path);
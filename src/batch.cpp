@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <limits>
+#include <stdexcept>
+#include "batch.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TEAM_BATCH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC emits any intrinsic without per-function target flags
+#define TEAM_BATCH_AVX2_TARGET
+#else
+#define TEAM_BATCH_AVX2_TARGET __attribute__((target("avx2,popcnt")))
+#endif
+#endif
+
+namespace { // file-local kernels and CPU detection
+    using Rows = BatchEvaluator::Rows;
+    constexpr FixedEffectiveness kNoResist = std::numeric_limits<FixedEffectiveness>::max();
+
+    // Base state of a call, padded to the row layout
+    struct BaseState {
+        const uint64_t* words;
+        const FixedEffectiveness* lanes;
+        uint32_t weakness;
+    };
+
+    size_t popcount(uint64_t word) { return std::bitset<64>(word).count(); }
+
+    void scorePortable(const Rows& rows, const BaseState& base, const TeamIndices* teams, size_t count, size_t firstSlot, BatchScore* out) {
+        for (size_t i = 0; i < count; ++i) {
+            const TeamIndices& team = teams[i];
+            size_t offense = 0;
+            for (size_t w = 0; w < rows.wordCount; ++w) {
+                uint64_t word = base.words[w];
+                for (size_t slot = firstSlot; slot < team.size(); ++slot) {
+                    word |= rows.coverage[team.slots[slot] * rows.wordCount + w];
+                }
+                offense += popcount(word);
+            }
+
+            std::array<FixedEffectiveness, NUM_TYPES> best;
+            std::copy(base.lanes, base.lanes + NUM_TYPES, best.begin());
+            uint32_t weakness = base.weakness;
+            for (size_t slot = firstSlot; slot < team.size(); ++slot) {
+                const FixedEffectiveness* row = rows.lanes + team.slots[slot] * BatchEvaluator::kLaneCount;
+                for (size_t t = 0; t < NUM_TYPES; ++t) best[t] = std::min(best[t], row[t]);
+                weakness += rows.weakness[team.slots[slot]];
+            }
+            int bonus = 0;
+            for (const auto resist : best) bonus += resistBonus(resist);
+            out[i] = BatchScore{static_cast<double>(offense), bonus - decodeEffectiveness(weakness)};
+        }
+    }
+
+#ifdef TEAM_BATCH_X86
+    // SSE2 has no unsigned 16-bit min, so lanes are kept biased by 0x8000 and compared signed.
+    // Three registers cover the 18 used lanes.
+    void scoreSse2(const Rows& rows, const BaseState& base, const TeamIndices* teams, size_t count, size_t firstSlot, BatchScore* out) {
+        constexpr size_t kRegisters = (NUM_TYPES + 7) / 8;
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i immune = _mm_xor_si128(_mm_setzero_si128(), bias);
+        const __m128i quarter = _mm_xor_si128(_mm_set1_epi16(kEffectivenessScale / 4), bias);
+        const __m128i half = _mm_xor_si128(_mm_set1_epi16(kEffectivenessScale / 2), bias);
+
+        for (size_t i = 0; i < count; ++i) {
+            const TeamIndices& team = teams[i];
+            size_t offense = 0;
+            for (size_t w = 0; w < rows.wordCount; w += 2) {
+                __m128i word = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base.words + w));
+                for (size_t slot = firstSlot; slot < team.size(); ++slot) {
+                    const uint64_t* row = rows.coverage + team.slots[slot] * rows.wordCount + w;
+                    word = _mm_or_si128(word, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row)));
+                }
+                alignas(16) uint64_t words[2];
+                _mm_store_si128(reinterpret_cast<__m128i*>(words), word);
+                offense += popcount(words[0]) + popcount(words[1]);
+            }
+
+            __m128i best[kRegisters];
+            for (size_t r = 0; r < kRegisters; ++r) {
+                best[r] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base.lanes + 8 * r)), bias);
+            }
+            uint32_t weakness = base.weakness;
+            for (size_t slot = firstSlot; slot < team.size(); ++slot) {
+                const FixedEffectiveness* row = rows.lanes + team.slots[slot] * BatchEvaluator::kLaneCount;
+                for (size_t r = 0; r < kRegisters; ++r) {
+                    const __m128i lanes = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 8 * r)), bias);
+                    best[r] = _mm_min_epi16(best[r], lanes);
+                }
+                weakness += rows.weakness[team.slots[slot]];
+            }
+            // movemask yields two bits per 16-bit lane: +2 lanes count their bits, +1 lanes half of them
+            size_t bonus = 0;
+            for (size_t r = 0; r < kRegisters; ++r) {
+                const __m128i two = _mm_or_si128(_mm_cmpeq_epi16(best[r], immune), _mm_cmpeq_epi16(best[r], quarter));
+                const __m128i one = _mm_cmpeq_epi16(best[r], half);
+                bonus += std::bitset<16>(_mm_movemask_epi8(two)).count() + std::bitset<16>(_mm_movemask_epi8(one)).count() / 2;
+            }
+            out[i] = BatchScore{static_cast<double>(offense), static_cast<double>(bonus) - decodeEffectiveness(weakness)};
+        }
+    }
+
+    TEAM_BATCH_AVX2_TARGET
+    void scoreAvx2(const Rows& rows, const BaseState& base, const TeamIndices* teams, size_t count, size_t firstSlot, BatchScore* out) {
+        const __m256i immune = _mm256_setzero_si256();
+        const __m256i quarter = _mm256_set1_epi16(kEffectivenessScale / 4);
+        const __m256i half = _mm256_set1_epi16(kEffectivenessScale / 2);
+
+        for (size_t i = 0; i < count; ++i) {
+            const TeamIndices& team = teams[i];
+            size_t offense = 0;
+            for (size_t w = 0; w < rows.wordCount; w += BatchEvaluator::kWordBlock) {
+                __m256i word = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base.words + w));
+                for (size_t slot = firstSlot; slot < team.size(); ++slot) {
+                    const uint64_t* row = rows.coverage + team.slots[slot] * rows.wordCount + w;
+                    word = _mm256_or_si256(word, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row)));
+                }
+                alignas(32) uint64_t words[BatchEvaluator::kWordBlock];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(words), word);
+                for (const auto packed : words) offense += static_cast<size_t>(_mm_popcnt_u64(packed));
+            }
+
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base.lanes));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base.lanes + 16));
+            uint32_t weakness = base.weakness;
+            for (size_t slot = firstSlot; slot < team.size(); ++slot) {
+                const FixedEffectiveness* row = rows.lanes + team.slots[slot] * BatchEvaluator::kLaneCount;
+                low = _mm256_min_epu16(low, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row)));
+                high = _mm256_min_epu16(high, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + 16)));
+                weakness += rows.weakness[team.slots[slot]];
+            }
+            int bonus = 0;
+            const __m256i halves[2] = {low, high};
+            for (const __m256i& best : halves) {
+                const __m256i two = _mm256_or_si256(_mm256_cmpeq_epi16(best, immune), _mm256_cmpeq_epi16(best, quarter));
+                const __m256i one = _mm256_cmpeq_epi16(best, half);
+                bonus += _mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_epi8(two))) +
+                    _mm_popcnt_u32(static_cast<unsigned>(_mm256_movemask_epi8(one))) / 2;
+            }
+            out[i] = BatchScore{static_cast<double>(offense), bonus - decodeEffectiveness(weakness)};
+        }
+    }
+
+    bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int regs[4];
+        __cpuid(regs, 1);
+        const bool osSavesYmm = (regs[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+        const bool popcnt = regs[2] & (1 << 23);
+        if (!osSavesYmm || !popcnt) return false;
+        __cpuidex(regs, 7, 0);
+        return regs[1] & (1 << 5);
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+    }
+#endif
+}
+
+BatchEvaluator::BatchEvaluator(const MemberProfileTable& profiles, BatchKernel kernel)
+    : kernel_(kernel), wordCount_(0) {
+    if (static_cast<uint8_t>(kernel) > static_cast<uint8_t>(bestKernel())) {
+        throw std::invalid_argument("Batch kernel not supported by this CPU or build");
+    }
+    for (const auto& profile : profiles) {
+        wordCount_ = std::max(wordCount_, profile.coverage.words().size());
+    }
+    wordCount_ = (wordCount_ + kWordBlock - 1) / kWordBlock * kWordBlock;
+
+    coverage_.assign(profiles.size() * wordCount_, 0);
+    lanes_.assign(profiles.size() * kLaneCount, kNoResist);
+    weakness_.reserve(profiles.size());
+    for (size_t m = 0; m < profiles.size(); ++m) {
+        const auto& words = profiles[m].coverage.words();
+        std::copy(words.begin(), words.end(), coverage_.begin() + m * wordCount_);
+        const auto& effectiveness = profiles[m].defense.effectiveness;
+        std::copy(effectiveness.begin(), effectiveness.end(), lanes_.begin() + m * kLaneCount);
+        weakness_.push_back(profiles[m].defense.totalWeakness);
+    }
+}
+
+BatchKernel BatchEvaluator::bestKernel() {
+#ifdef TEAM_BATCH_X86
+    static const BatchKernel best = cpuHasAvx2() ? BatchKernel::AVX2 : BatchKernel::SSE2;
+    return best;
+#else
+    return BatchKernel::Portable;
+#endif
+}
+
+void BatchEvaluator::score(
+    const CoverageSet& baseCoverage,
+    const TeamDefense& baseDefense,
+    const TeamIndices* teams,
+    size_t count,
+    size_t firstSlot,
+    BatchScore* out
+) const {
+    // Scratch reused across calls; blocks can be a handful of teams
+    thread_local std::vector<uint64_t> baseWords;
+    baseWords.assign(wordCount_, 0);
+    const auto& words = baseCoverage.words();
+    std::copy(words.begin(), words.begin() + std::min(words.size(), wordCount_), baseWords.begin());
+    std::array<FixedEffectiveness, kLaneCount> baseLanes;
+    baseLanes.fill(kNoResist);
+    std::copy(baseDefense.bestResist.begin(), baseDefense.bestResist.end(), baseLanes.begin());
+
+    const Rows rows{wordCount_, coverage_.data(), lanes_.data(), weakness_.data()};
+    const BaseState base{baseWords.data(), baseLanes.data(), baseDefense.weakness};
+    switch (kernel_) {
+#ifdef TEAM_BATCH_X86
+    case BatchKernel::AVX2:
+        scoreAvx2(rows, base, teams, count, firstSlot, out);
+        break;
+    case BatchKernel::SSE2:
+        scoreSse2(rows, base, teams, count, firstSlot, out);
+        break;
+#endif
+    default:
+        scorePortable(rows, base, teams, count, firstSlot, out);
+        break;
+    }
+}
+
+void BatchEvaluator::score(const TeamIndices* teams, size_t count, BatchScore* out) const {
+    score(CoverageSet(), TeamDefense(), teams, count, 0, out);
+}
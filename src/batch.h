@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "profile.h"
+#include "team.h"
+
+// Instruction set a BatchEvaluator scores with, narrowest first
+enum class BatchKernel : uint8_t {
+    Portable, // plain loops, any target
+    SSE2,     // 128-bit lanes, the x86-64 baseline
+    AVX2      // 256-bit lanes plus popcnt, used when the CPU reports both
+};
+
+struct BatchScore {
+    double offense;
+    double defense;
+};
+
+// Scores blocks of teams given as index tuples into a member profile table. The table is
+// repacked once into padded rows (coverage words to a multiple of four, the 18 defense lanes to
+// 32) so a member is OR'd into the coverage and min-reduced into the defense with whole
+// registers, and the kernel is picked at construction from what the CPU supports.
+// Every team of a call extends one base state (pinned members, or any shared prefix).
+class BatchEvaluator {
+public:
+    // Throws std::invalid_argument when the kernel is wider than bestKernel()
+    explicit BatchEvaluator(const MemberProfileTable& profiles, BatchKernel kernel = bestKernel());
+
+    // Widest kernel this build and CPU can run
+    static BatchKernel bestKernel();
+    BatchKernel kernel() const { return kernel_; }
+    size_t memberCount() const { return weakness_.size(); }
+
+    // out[i] receives the scores of the base state plus the members teams[i].slots[firstSlot..size()),
+    // the same values evaluateOffense / evaluateDefense give for the accumulated coverage and defense.
+    void score(
+        const CoverageSet& baseCoverage,
+        const TeamDefense& baseDefense,
+        const TeamIndices* teams,
+        size_t count,
+        size_t firstSlot,
+        BatchScore* out
+    ) const;
+    // Teams scored from their members alone
+    void score(const TeamIndices* teams, size_t count, BatchScore* out) const;
+
+    // Row layout, shared with the kernels
+    static constexpr size_t kWordBlock = 4;  // coverage words per 256-bit register
+    static constexpr size_t kLaneCount = 32; // defense lanes per row, NUM_TYPES used
+
+    struct Rows {
+        size_t wordCount;               // padded coverage words per member
+        const uint64_t* coverage;       // [member * wordCount + w]
+        const FixedEffectiveness* lanes; // [member * kLaneCount + t], padding lanes hold the max
+        const uint32_t* weakness;       // [member]
+    };
+
+private:
+    BatchKernel kernel_;
+    size_t wordCount_;
+    std::vector<uint64_t> coverage_;
+    std::vector<FixedEffectiveness> lanes_;
+    std::vector<uint32_t> weakness_;
+};
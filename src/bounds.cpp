@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <limits>
+#include "bounds.h"
+#include "team.h"
+
+ScoreBounds::ScoreBounds(const MemberProfileTable& profiles, const RankingPolicy& ranking)
+    : profiles_(profiles), ranking_(ranking) {
+    memberBonus_.reserve(profiles.size());
+    for (const auto& profile : profiles) {
+        BonusVector bonus;
+        for (size_t t = 0; t < NUM_TYPES; ++t) {
+            bonus[t] = resistBonus(profile.defense.effectiveness[t]);
+        }
+        memberBonus_.push_back(bonus);
+    }
+}
+
+BonusVector ScoreBounds::prefixBonus(const TeamDefense& prefixDefense) {
+    BonusVector bonus;
+    for (size_t t = 0; t < NUM_TYPES; ++t) {
+        bonus[t] = resistBonus(prefixDefense.bestResist[t]);
+    }
+    return bonus;
+}
+
+void ScoreBounds::memberGains(
+    const CoverageSet& prefixCoverage,
+    const BonusVector& prefixBonus,
+    size_t fromIndex,
+    std::vector<double>& combinedGain,
+    std::vector<double>& defenseGain
+) const {
+    for (size_t i = fromIndex; i < profiles_.size(); ++i) {
+        // A team's best resist per type comes from one member, so the new member
+        // can at most lift each type from the prefix's bonus to its own
+        double bonusGain = 0.0;
+        for (size_t t = 0; t < NUM_TYPES; ++t) {
+            bonusGain += std::max(0.0, memberBonus_[i][t] - prefixBonus[t]);
+        }
+        const double coverageGain = static_cast<double>(profiles_[i].coverage.countNotIn(prefixCoverage));
+        defenseGain[i] = bonusGain - decodeEffectiveness(profiles_[i].defense.totalWeakness);
+        // Weights are non-negative, so the weighted sum of the two bounds bounds the combined gain
+        combinedGain[i] = ranking_.combine(coverageGain, defenseGain[i]);
+    }
+}
+
+double ScoreBounds::ancestorSlack(const BonusVector& ancestorBonus, const BonusVector& prefixBonus) {
+    double slack = 0.0;
+    for (size_t t = 0; t < NUM_TYPES; ++t) {
+        slack += std::max(0.0, ancestorBonus[t] - prefixBonus[t]);
+    }
+    return slack;
+}
+
+void bestFollowingSums(
+    const std::vector<double>& values,
+    const std::vector<size_t>& copies,
+    size_t fromIndex,
+    size_t fromCopies,
+    size_t count,
+    std::vector<double>& restSums
+) {
+    // Scan right to left keeping the `count` largest values after i seen so far, descending
+    std::vector<double> best;
+    best.reserve(count + 1);
+    for (size_t i = values.size(); i-- > fromIndex;) {
+        const double value = values[i];
+        const size_t available = (i == fromIndex) ? fromCopies : copies[i];
+        if (available == 0) {
+            restSums[i] = std::numeric_limits<double>::lowest();
+            continue;
+        }
+
+        // Merge i's further copies with the best later values
+        size_t taken = 0;
+        size_t extra = available - 1;
+        double sum = 0.0;
+        for (auto later = best.begin(); taken < count && (later != best.end() || extra > 0); ++taken) {
+            if (extra > 0 && (later == best.end() || value >= *later)) {
+                sum += value;
+                --extra;
+            } else {
+                sum += *later++;
+            }
+        }
+        restSums[i] = (taken == count) ? sum : std::numeric_limits<double>::lowest();
+
+        for (size_t copy = 0; copy < std::min(copies[i], count); ++copy) {
+            if (best.size() == count && value <= best.back()) break;
+            best.insert(std::upper_bound(best.begin(), best.end(), value, std::greater<double>()), value);
+            if (best.size() > count) best.pop_back();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "profile.h"
+#include "ranking.h"
+#include "types.h"
+
+using BonusVector = std::array<double, NUM_TYPES>;
+
+// Optimistic (admissible) gains for completing a partial team, used to prune branch-and-bound
+// search. Coverage and resist bonuses can only overlap between members while weaknesses add up
+// exactly, so adding members R to a prefix P raises its scores by at most the sum over R of each
+// member's gain against P alone. No completion can beat the bound, so a losing prefix is skipped.
+class ScoreBounds {
+public:
+    ScoreBounds(const MemberProfileTable& profiles, const RankingPolicy& ranking);
+
+    // Resist bonus the prefix currently earns against each attacking type
+    static BonusVector prefixBonus(const TeamDefense& prefixDefense);
+
+    // For every member index in [fromIndex, end): an upper bound on how much adding it to the
+    // prefix can raise the ranking's combined score (combinedGain) and the defensive score (defenseGain).
+    // Entries before fromIndex are left untouched.
+    void memberGains(
+        const CoverageSet& prefixCoverage,
+        const BonusVector& prefixBonus,
+        size_t fromIndex,
+        std::vector<double>& combinedGain,
+        std::vector<double>& defenseGain
+    ) const;
+
+    // Gains computed against an ancestor stay valid for a longer prefix once this slack is added
+    // per member: the bonus the prefix lost relative to the ancestor on any type (normally 0,
+    // but an ability-reduced multiplier like 0.125 earns less than a plain 0.25 resist).
+    static double ancestorSlack(const BonusVector& ancestorBonus, const BonusVector& prefixBonus);
+
+private:
+    const MemberProfileTable& profiles_;
+    RankingPolicy ranking_;
+    std::vector<BonusVector> memberBonus_;  // resistBonus of each member's own multipliers
+};
+
+// For every member i in [fromIndex, end): the sum of the `count` largest values among the members
+// that can still follow i in a team, i.e. i's remaining copies and every later member j up to
+// copies[j] times. Member fromIndex has fromCopies copies left, including the one placed at i.
+// restSums[i] receives the sum (lowest() when too few members follow).
+void bestFollowingSums(
+    const std::vector<double>& values,
+    const std::vector<size_t>& copies,
+    size_t fromIndex,
+    size_t fromCopies,
+    size_t count,
+    std::vector<double>& restSums
+);
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <stdexcept>
+#include "combinations.h"
+
+size_t binomialCoefficient(size_t n, size_t k) {
+    if (k > n) return 0;
+    if (k == 0 || k == n) return 1;
+    if (k > n - k) k = n - k;
+    size_t result = 1;
+    for (size_t i = 1; i <= k; ++i) {
+        result = result * (n - k + i) / i;
+    }
+    return result;
+}
+
+CombinationEnumerator::CombinationEnumerator(size_t n, size_t k, size_t startRank)
+    : n_(n), k_(k), rank_(startRank), done_(false) {
+    if (startRank >= binomialCoefficient(n, k)) {
+        done_ = true;
+        return;
+    }
+    indices_ = unrank(n, k, startRank);
+}
+
+bool CombinationEnumerator::next() {
+    if (done_) return false;
+
+    // Find the rightmost slot that can still move right
+    size_t slot = k_;
+    while (slot > 0 && indices_[slot - 1] == n_ - k_ + (slot - 1)) {
+        --slot;
+    }
+    if (slot == 0) {
+        done_ = true;
+        return false;
+    }
+
+    --slot;
+    changedSlot_ = slot;
+    ++indices_[slot];
+    for (size_t i = slot + 1; i < k_; ++i) {
+        indices_[i] = indices_[i - 1] + 1;
+    }
+    ++rank_;
+    return true;
+}
+
+std::vector<size_t> CombinationEnumerator::unrank(size_t n, size_t k, size_t rank) {
+    if (rank >= binomialCoefficient(n, k)) {
+        throw std::out_of_range("Combination rank out of range");
+    }
+
+    std::vector<size_t> result;
+    result.reserve(k);
+    size_t candidate = 0;
+    for (size_t slot = 0; slot < k; ++slot) {
+        // Skip whole blocks of combinations that start with a smaller candidate in this slot
+        while (true) {
+            size_t block = binomialCoefficient(n - candidate - 1, k - slot - 1);
+            if (rank < block) break;
+            rank -= block;
+            ++candidate;
+        }
+        result.push_back(candidate);
+        ++candidate;
+    }
+    return result;
+}
+
+MultisetCounter::MultisetCounter(std::vector<size_t> capacities, size_t maxSize)
+    : MultisetCounter(capacities, maxSize, std::vector<Resources>(capacities.size()), Resources{}) {}
+
+MultisetCounter::MultisetCounter(std::vector<size_t> capacities, size_t maxSize, std::vector<Resources> costs, Resources budget)
+    : capacities_(std::move(capacities)), maxSize_(maxSize), costs_(std::move(costs)), budget_(budget) {
+    if (costs_.size() != capacities_.size()) {
+        throw std::invalid_argument("MultisetCounter needs one cost per item");
+    }
+    const size_t items = capacities_.size();
+    size_t budgetStates = 1;
+    for (const size_t limit : budget_) budgetStates *= limit + 1;
+    // Budget left for a state number, the last resource varying fastest like suffixIndex
+    auto budgetLeft = [this](size_t state) {
+        Resources left{};
+        for (size_t r = kResourceCount; r-- > 0;) {
+            left[r] = state % (budget_[r] + 1);
+            state /= budget_[r] + 1;
+        }
+        return left;
+    };
+
+    suffixCounts_.assign((items + 1) * (maxSize_ + 1) * budgetStates, 0);
+    for (size_t state = 0; state < budgetStates; ++state) {
+        suffixCounts_[suffixIndex(items, 0, budgetLeft(state))] = 1; // the empty multiset of no items
+    }
+    for (size_t item = items; item-- > 0;) {
+        for (size_t size = 0; size <= maxSize_; ++size) {
+            for (size_t state = 0; state < budgetStates; ++state) {
+                // Take 0..capacity copies of this item while they fit, the rest from the items after it
+                const Resources left = budgetLeft(state);
+                Resources after = left;
+                size_t total = 0;
+                for (size_t copies = 0; copies <= std::min(capacities_[item], size); ++copies) {
+                    if (copies > 0) {
+                        if (!affords(item, after)) break;
+                        after = spend(item, after);
+                    }
+                    total += suffixCounts_[suffixIndex(item + 1, size - copies, after)];
+                }
+                suffixCounts_[suffixIndex(item, size, left)] = total;
+            }
+        }
+    }
+
+    std::vector<Resources> groupCosts;
+    for (size_t item = items; item-- > 0;) {
+        if (capacities_[item] == 0) continue;
+        const size_t group = std::find(groupCosts.begin(), groupCosts.end(), costs_[item]) - groupCosts.begin();
+        if (group == groupCosts.size()) {
+            groupCosts.push_back(costs_[item]);
+            nextOfCost_.emplace_back(items + 1, items);
+        }
+        nextOfCost_[group][item] = item;
+    }
+    for (auto& next : nextOfCost_) {
+        for (size_t item = items; item-- > 0;) next[item] = std::min(next[item], next[item + 1]);
+    }
+}
+
+size_t MultisetCounter::suffixIndex(size_t first, size_t size, const Resources& budgetLeft) const {
+    size_t index = first * (maxSize_ + 1) + size;
+    for (size_t r = 0; r < kResourceCount; ++r) index = index * (budget_[r] + 1) + budgetLeft[r];
+    return index;
+}
+
+bool MultisetCounter::affords(size_t item, const Resources& budgetLeft) const {
+    for (size_t r = 0; r < kResourceCount; ++r) {
+        if (costs_[item][r] > budgetLeft[r]) return false;
+    }
+    return true;
+}
+
+MultisetCounter::Resources MultisetCounter::spend(size_t item, Resources budgetLeft) const {
+    for (size_t r = 0; r < kResourceCount; ++r) budgetLeft[r] -= costs_[item][r];
+    return budgetLeft;
+}
+
+size_t MultisetCounter::count(size_t first, size_t size) const {
+    return count(first, size, budget_);
+}
+
+size_t MultisetCounter::count(size_t first, size_t size, const Resources& budgetLeft) const {
+    if (size > maxSize_) return 0;
+    return suffixCounts_[suffixIndex(std::min(first, capacities_.size()), size, budgetLeft)];
+}
+
+size_t MultisetCounter::count(size_t first, size_t firstCapacity, size_t size) const {
+    return count(first, firstCapacity, size, budget_);
+}
+
+size_t MultisetCounter::count(size_t first, size_t firstCapacity, size_t size, const Resources& budgetLeft) const {
+    if (first >= capacities_.size()) return count(first, size, budgetLeft);
+    if (size > maxSize_) return 0;
+    Resources after = budgetLeft;
+    size_t total = 0;
+    for (size_t copies = 0; copies <= std::min(firstCapacity, size); ++copies) {
+        if (copies > 0) {
+            if (!affords(first, after)) break;
+            after = spend(first, after);
+        }
+        total += count(first + 1, size - copies, after);
+    }
+    return total;
+}
+
+size_t MultisetCounter::firstItem(size_t first, size_t firstCapacity, size_t size, const Resources& budgetLeft) const {
+    const size_t items = capacities_.size();
+    if (first >= items || size == 0 || size > maxSize_) return items;
+    auto starts = [&](size_t item, size_t capacity) {
+        return capacity > 0 && affords(item, budgetLeft) && count(item, capacity - 1, size - 1, spend(item, budgetLeft)) > 0;
+    };
+    if (starts(first, firstCapacity)) return first;
+
+    // Later items of one cost only lose options, so each cost group's first item decides for the group
+    size_t best = items;
+    for (const auto& next : nextOfCost_) {
+        const size_t item = next[first + 1];
+        if (item < best && starts(item, capacities_[item])) best = item;
+    }
+    return best;
+}
+
+MultisetEnumerator::MultisetEnumerator(const MultisetCounter& counter, size_t size, size_t startRank)
+    : MultisetEnumerator(counter, 0, counter.itemCount() > 0 ? counter.capacity(0) : 0, size, counter.budget(), startRank) {}
+
+MultisetEnumerator::MultisetEnumerator(
+    const MultisetCounter& counter,
+    size_t first,
+    size_t firstCapacity,
+    size_t size,
+    size_t startRank
+) : MultisetEnumerator(counter, first, firstCapacity, size, counter.budget(), startRank) {}
+
+MultisetEnumerator::MultisetEnumerator(
+    const MultisetCounter& counter,
+    size_t first,
+    size_t firstCapacity,
+    size_t size,
+    const Resources& budget,
+    size_t startRank
+) : counter_(counter), first_(first), firstCapacity_(firstCapacity), size_(size), budget_(budget), rank_(startRank), done_(false),
+    left_(size + 1, budget) {
+    if (startRank >= total()) {
+        done_ = true;
+        return;
+    }
+    indices_ = unrank(startRank);
+    for (size_t slot = 0; slot < size_; ++slot) left_[slot + 1] = counter_.spend(indices_[slot], left_[slot]);
+}
+
+bool MultisetEnumerator::next() {
+    return advance(size_);
+}
+
+size_t MultisetEnumerator::skip(size_t slot) {
+    if (done_) return 0;
+
+    // Multisets still ahead in the subtree: the current one, plus for every later slot those
+    // that keep the slots before it and place a greater item there. Items past indices_[j]
+    // are unused by the slots before j, so each keeps its full capacity.
+    size_t skipped = 1;
+    for (size_t j = slot + 1; j < size_; ++j) {
+        skipped += counter_.count(indices_[j] + 1, size_ - j, left_[j]);
+    }
+    rank_ += skipped - 1;
+    if (!advance(slot + 1)) rank_ = total();
+    return skipped;
+}
+
+bool MultisetEnumerator::advance(size_t slotLimit) {
+    if (done_) return false;
+
+    // Find the rightmost slot whose value can grow while the slots after it can still be filled
+    size_t slot = slotLimit;
+    while (slot > 0 && counter_.count(indices_[slot - 1] + 1, size_ - (slot - 1), left_[slot - 1]) == 0) {
+        --slot;
+    }
+    if (slot == 0) {
+        done_ = true;
+        return false;
+    }
+
+    // Refill the tail with the smallest items that still leave it completable within the budget
+    --slot;
+    changedSlot_ = slot;
+    size_t item = indices_[slot] + 1;
+    size_t used = 0;
+    for (size_t i = slot; i < size_; ++i) {
+        const size_t chosen = counter_.firstItem(item, copies(item) - used, size_ - i, left_[i]);
+        if (chosen != item) {
+            item = chosen;
+            used = 0;
+        }
+        indices_[i] = item;
+        ++used;
+        left_[i + 1] = counter_.spend(item, left_[i]);
+    }
+    ++rank_;
+    return true;
+}
+
+std::vector<size_t> MultisetEnumerator::unrank(size_t rank) const {
+    if (rank >= total()) {
+        throw std::out_of_range("Multiset rank out of range");
+    }
+
+    std::vector<size_t> result;
+    result.reserve(size_);
+    size_t candidate = first_;
+    size_t used = 0; // copies of candidate already placed
+    Resources left = budget_;
+    for (size_t slot = 0; slot < size_; ++slot) {
+        // Skip whole blocks of multisets that place a smaller candidate in this slot
+        while (true) {
+            const size_t copiesLeft = copies(candidate) - used;
+            const size_t block = (copiesLeft == 0 || !counter_.affords(candidate, left))
+                ? 0 : counter_.count(candidate, copiesLeft - 1, size_ - slot - 1, counter_.spend(candidate, left));
+            if (rank < block) break;
+            rank -= block;
+            ++candidate;
+            used = 0;
+        }
+        result.push_back(candidate);
+        ++used;
+        left = counter_.spend(candidate, left);
+    }
+    return result;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Number of k-subsets of n items. Returns 0 when k > n.
+size_t binomialCoefficient(size_t n, size_t k);
+
+// Enumerates the k-subsets of {0, ..., n-1} as ascending index arrays in lexicographic order.
+// Each step is amortized O(1): only the tail of the index array past the advanced slot is rewritten.
+// Enumeration can start at any rank in [0, C(n, k)), so a range of ranks can be handed to a worker.
+class CombinationEnumerator {
+public:
+    CombinationEnumerator(size_t n, size_t k, size_t startRank = 0);
+
+    // Current combination, ascending
+    const std::vector<size_t>& indices() const { return indices_; }
+    // Lexicographic rank of the current combination
+    size_t rank() const { return rank_; }
+    bool done() const { return done_; }
+
+    // Advances to the next combination. Returns false once the last one has been passed.
+    bool next();
+    // Lowest slot the last next() rewrote (0 before the first step); the slots before it are unchanged
+    size_t changedSlot() const { return changedSlot_; }
+
+    // Total number of combinations this enumerator walks from rank 0
+    size_t total() const { return binomialCoefficient(n_, k_); }
+
+    // Combination with the given lexicographic rank
+    static std::vector<size_t> unrank(size_t n, size_t k, size_t rank);
+
+private:
+    size_t n_;
+    size_t k_;
+    size_t rank_;
+    bool done_;
+    size_t changedSlot_ = 0;
+    std::vector<size_t> indices_;
+};
+
+// Counts multisets drawn from items {0, ..., n-1} where item i may appear up to capacities[i]
+// times (a capacity of 0 excludes the item). With every capacity 1 the counts are binomials.
+// Every copy of item i may also spend costs[i] of up to two limited resources; only multisets
+// whose total spend stays within the budget are counted (e.g. at most two non-ghosts and one mega).
+class MultisetCounter {
+public:
+    static constexpr size_t kResourceCount = 2;
+    using Resources = std::array<size_t, kResourceCount>;
+
+    MultisetCounter(std::vector<size_t> capacities, size_t maxSize);
+    MultisetCounter(std::vector<size_t> capacities, size_t maxSize, std::vector<Resources> costs, Resources budget);
+
+    size_t itemCount() const { return capacities_.size(); }
+    size_t capacity(size_t item) const { return capacities_[item]; }
+    const std::vector<size_t>& capacities() const { return capacities_; }
+    size_t maxSize() const { return maxSize_; }
+    const Resources& cost(size_t item) const { return costs_[item]; }
+    const Resources& budget() const { return budget_; }
+
+    // Number of `size`-multisets of the items [first, n) within the budget
+    size_t count(size_t first, size_t size) const;
+    // Same, with item `first` limited to firstCapacity copies
+    size_t count(size_t first, size_t firstCapacity, size_t size) const;
+    // Same two, within what is left of the budget (at most budget() per resource)
+    size_t count(size_t first, size_t size, const Resources& budgetLeft) const;
+    size_t count(size_t first, size_t firstCapacity, size_t size, const Resources& budgetLeft) const;
+
+    // Smallest item of [first, n) that starts at least one multiset counted by
+    // count(first, firstCapacity, size, budgetLeft), or itemCount() when there is none
+    size_t firstItem(size_t first, size_t firstCapacity, size_t size, const Resources& budgetLeft) const;
+
+    // Whether a copy of the item fits in the budget left, and what is left after it
+    bool affords(size_t item, const Resources& budgetLeft) const;
+    Resources spend(size_t item, Resources budgetLeft) const;
+
+private:
+    size_t suffixIndex(size_t first, size_t size, const Resources& budgetLeft) const;
+
+    std::vector<size_t> capacities_;
+    size_t maxSize_;
+    std::vector<Resources> costs_;
+    Resources budget_;
+    std::vector<size_t> suffixCounts_; // [item][size][budget left per resource], items [item, n)
+    // Items are grouped by cost; nextOfCost_[g][i] is the first item >= i of group g with a nonzero capacity
+    std::vector<std::vector<size_t>> nextOfCost_;
+};
+
+// Enumerates `size`-multisets of a MultisetCounter's items as non-decreasing index arrays in
+// lexicographic order, optionally restricted to the items [first, n) with item `first` limited
+// to firstCapacity copies and to what is left of the counter's budget. Only multisets within the
+// budget are visited and ranked, so the work is proportional to them. Same stepping and ranking
+// interface as CombinationEnumerator, which it reproduces exactly when every capacity is 1.
+class MultisetEnumerator {
+public:
+    using Resources = MultisetCounter::Resources;
+
+    MultisetEnumerator(const MultisetCounter& counter, size_t size, size_t startRank = 0);
+    MultisetEnumerator(const MultisetCounter& counter, size_t first, size_t firstCapacity, size_t size, size_t startRank = 0);
+    MultisetEnumerator(
+        const MultisetCounter& counter,
+        size_t first,
+        size_t firstCapacity,
+        size_t size,
+        const Resources& budget,
+        size_t startRank = 0
+    );
+
+    // Current multiset, non-decreasing
+    const std::vector<size_t>& indices() const { return indices_; }
+    size_t rank() const { return rank_; }
+    bool done() const { return done_; }
+
+    // Advances to the next multiset. Returns false once the last one has been passed.
+    bool next();
+    // Advances past every multiset that shares the current slots [0, slot], i.e. the rest of the
+    // subtree below that prefix. Returns how many multisets were passed, counting the current one;
+    // once done, rank() is total().
+    size_t skip(size_t slot);
+    // Lowest slot the last next() or skip() rewrote (0 before the first step); the slots before it are unchanged
+    size_t changedSlot() const { return changedSlot_; }
+
+    // Total number of multisets this enumerator walks from rank 0
+    size_t total() const { return counter_.count(first_, firstCapacity_, size_, budget_); }
+
+    // Multiset with the given lexicographic rank. Throws std::out_of_range past total().
+    std::vector<size_t> unrank(size_t rank) const;
+
+private:
+    size_t copies(size_t item) const { return item == first_ ? firstCapacity_ : counter_.capacity(item); }
+    // Moves to the smallest multiset that is greater in one of the slots [0, slotLimit)
+    bool advance(size_t slotLimit);
+
+    const MultisetCounter& counter_;
+    size_t first_;
+    size_t firstCapacity_;
+    size_t size_;
+    Resources budget_;
+    size_t rank_;
+    bool done_;
+    size_t changedSlot_ = 0;
+    std::vector<size_t> indices_;
+    std::vector<Resources> left_; // [slot]: budget left before that slot
+};
@@ -1,183 +1,1297 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
-#include <queue>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
 #include <set>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include "batch.h"
+#include "bounds.h"
+#include "combinations.h"
 #include "generator.h"
 #include "logger.h"
+#include "ranking.h"
+#include "scheduler.h"
 #include "types.h"
 
 namespace { // file-local helpers, constants, and aliases
-    using std::priority_queue;
     using std::to_string;
     using std::vector;
 
     static constexpr size_t kProgressReportInterval = 100000;
+    // Teams a worker processes before publishing them to the shared progress counter.
+    // Divides kProgressReportInterval so serial runs report at the same counts as before.
+    static constexpr size_t kProgressFlushInterval = 1000;
+    // Complete teams scored per BatchEvaluator call by the exhaustive search
+    static constexpr size_t kBatchSize = 64;
+    // Heuristic search: evaluations between reads of the clock, swaps per annealing chain, and the
+    // starting temperature as an offense change (a defense change of a quarter of it)
+    static constexpr size_t kClockCheckInterval = 256;
+    static constexpr size_t kAnnealingChainLength = 20000;
+    static constexpr double kStartTemperature = 2.0;
+    // Relative slack on branch-and-bound cut-offs, far above the rounding error of a bound
+    static constexpr double kBoundTolerance = 1e-9;
 
-    // Min-heap comparator: returns true when 'a' is better than 'b' 
-    // (priority_queue with this comparator places the worst team at top)
-    struct ScoredTeamMinComparator {
-        bool operator()(const ScoredTeam& a, const ScoredTeam& b) const {
-            if (a.offensiveScore != b.offensiveScore) return a.offensiveScore > b.offensiveScore;
-            if (a.defensiveScore != b.defensiveScore) return a.defensiveScore > b.defensiveScore;
-            // deterministic tie-breaker by concatenated member names
-            std::string sa, sb;
-            for (const auto &m : a.team) { if (!sa.empty()) sa.push_back('|'); sa += m.name; }
-            for (const auto &m : b.team) { if (!sb.empty()) sb.push_back('|'); sb += m.name; }
-            return sa > sb;
+    bool isMega(const Pokemon& p) {
+        string name(p.name);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        return name.find("mega") != string::npos;
+    }
+
+    bool isGhost(const Pokemon& p) {
+        return p.primaryType == Type::Ghost || (p.secondaryType && *p.secondaryType == Type::Ghost);
+    }
+
+    // A ConflictRule compiled into the limits a ConflictState is held to
+    struct ConflictLimits {
+        bool forbidTypeOverlap;
+        uint8_t maxNonGhosts;
+        uint8_t maxMegas = 1;
+
+        explicit ConflictLimits(ConflictRule rules)
+            : forbidTypeOverlap(hasRule(rules, ConflictRule::NoTypeOverlap)),
+              maxNonGhosts(hasRule(rules, ConflictRule::TGOM_Ghost) ? 2 : std::numeric_limits<uint8_t>::max()) {}
+
+        bool limitsNonGhosts() const { return maxNonGhosts != std::numeric_limits<uint8_t>::max(); }
+    };
+
+    // Running conflict counters of a (partial) team. Every roster member's own counters (its type
+    // mask and ghost and mega flags) are built once and merged per candidate; the pinned members
+    // are merged once into a base state that each candidate's check starts from. Counters only
+    // grow as members are added, so a conflicting prefix rules out every team extending it.
+    struct ConflictState {
+        uint32_t types = 0;            // bit per Type seen so far
+        bool overlappingTypes = false; // some type appeared twice
+        uint8_t nonGhosts = 0;
+        uint8_t megas = 0;
+
+        void add(const Pokemon& member) {
+            addType(member.primaryType);
+            if (member.secondaryType) addType(*member.secondaryType);
+            if (!isGhost(member)) ++nonGhosts;
+            if (isMega(member)) ++megas;
+        }
+
+        void merge(const ConflictState& other) {
+            overlappingTypes = overlappingTypes || other.overlappingTypes || (types & other.types) != 0;
+            types |= other.types;
+            nonGhosts += other.nonGhosts;
+            megas += other.megas;
+        }
+
+        bool conflicts(const ConflictLimits& limits) const {
+            return (overlappingTypes & limits.forbidTypeOverlap) |
+                (nonGhosts > limits.maxNonGhosts) |
+                (megas > limits.maxMegas);
+        }
+
+    private:
+        void addType(Type type) {
+            const uint32_t bit = uint32_t{1} << static_cast<size_t>(type);
+            if (types & bit) overlappingTypes = true;
+            types |= bit;
         }
     };
 
-    using MinHeap = std::priority_queue<ScoredTeam, std::vector<ScoredTeam>, ScoredTeamMinComparator>;
+    // The counted limits (non-ghosts and megas) as MultisetCounter resources, so teams past them
+    // are never enumerated: what one member spends, and what a state within the limits has left.
+    // Type overlap depends on which types meet and stays a per-prefix check.
+    MultisetCounter::Resources conflictCost(const ConflictLimits& limits, const ConflictState& member) {
+        return {limits.limitsNonGhosts() ? member.nonGhosts : size_t{0}, member.megas};
+    }
+
+    MultisetCounter::Resources conflictBudget(const ConflictLimits& limits, const ConflictState& state) {
+        return {limits.limitsNonGhosts() ? size_t{limits.maxNonGhosts} - state.nonGhosts : size_t{0},
+            size_t{limits.maxMegas} - state.megas};
+    }
 
-    bool hasOverlappingTypes(const Team& team) {
-        std::set<Type> seenTypes;
-        for (const auto& member : team) {
-            if (seenTypes.count(member.primaryType)) return true;
-            seenTypes.insert(member.primaryType);
-            if (member.secondaryType) {
-                if (seenTypes.count(*member.secondaryType)) return true;
-                seenTypes.insert(*member.secondaryType);
+    // True when swapping `worse` for `better` can't create a conflict the team didn't have
+    bool conflictsNoMore(const Pokemon& better, const Pokemon& worse, ConflictRule conflictRule) {
+        if (isMega(better) && !isMega(worse)) return false;
+        if (hasRule(conflictRule, ConflictRule::NoTypeOverlap)) {
+            // better's types must be a subset of worse's
+            auto hasType = [&worse](Type type) {
+                return worse.primaryType == type || (worse.secondaryType && *worse.secondaryType == type);
+            };
+            if (!hasType(better.primaryType)) return false;
+            if (better.secondaryType && !hasType(*better.secondaryType)) return false;
+        }
+        if (hasRule(conflictRule, ConflictRule::TGOM_Ghost)) {
+            if (isGhost(worse) && !isGhost(better)) return false;
+        }
+        return true;
+    }
+
+    // True when `better` can take `worse`'s place in any team without lowering its offense or
+    // defense or breaking the conflict rule: it covers every target `worse` covers and takes no
+    // more from any attacking type
+    bool dominates(
+        const Pokemon& better,
+        const MemberProfile& betterProfile,
+        const Pokemon& worse,
+        const MemberProfile& worseProfile,
+        ConflictRule conflictRule
+    ) {
+        if (worseProfile.coverage.countNotIn(betterProfile.coverage) != 0) return false;
+        for (size_t t = 0; t < NUM_TYPES; ++t) {
+            if (!resistsAtLeastAsWell(betterProfile.defense.effectiveness[t], worseProfile.defense.effectiveness[t])) return false;
+        }
+        return conflictsNoMore(better, worse, conflictRule);
+    }
+
+    // Flags the pool members (roster indices from pinnedCount on) that no top-N result needs.
+    // A member is dropped once topN + slotsToFill - 1 kept members dominate it: any team holding
+    // it can then swap it for at least topN different dominators not already on the team, so the
+    // top-N scores are unchanged (teams tied with them may be reported instead). Members that
+    // dominate each other are ordered by index so such a group never drops all of its members.
+    vector<bool> findDominatedMembers(
+        const PokemonList& roster,
+        const MemberProfileTable& profiles,
+        size_t pinnedCount,
+        size_t slotsToFill,
+        size_t topN,
+        ConflictRule conflictRule
+    ) {
+        vector<bool> dominated(roster.size(), false);
+        if (slotsToFill == 0 || topN == 0) return dominated;
+
+        const size_t required = topN + slotsToFill - 1;
+        for (size_t worse = pinnedCount; worse < roster.size(); ++worse) {
+            size_t dominators = 0;
+            for (size_t better = pinnedCount; better < roster.size() && dominators < required; ++better) {
+                if (better == worse) continue;
+                if (!dominates(roster[better], profiles[better], roster[worse], profiles[worse], conflictRule)) continue;
+                if (better < worse && dominates(roster[worse], profiles[worse], roster[better], profiles[better], conflictRule)) continue;
+                ++dominators;
             }
+            // Dominance is transitive, so a dropped dominator's own kept dominators stand in for it
+            dominated[worse] = (dominators >= required);
         }
-        return false;
+        return dominated;
     }
 
-    bool isMega(const Pokemon& p) {
-        string name = p.name;
-        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-        return name.find("mega") != string::npos;
+    Team materializeTeam(const PokemonList& roster, const TeamIndices& indices) {
+        Team team;
+        team.reserve(indices.size());
+        for (const auto index : indices) team.push_back(roster[index]);
+        return team;
     }
 
-    bool hasConflict(const Team& team, const ConflictRule& conflictRule) {
-        if (conflictRule == ConflictRule::NoTypeOverlap) {
-            if(hasOverlappingTypes(team)) return true;
+    // Pruning state shared by all branch-and-bound workers
+    class BranchAndBoundShared {
+    public:
+        // Every worker heap's N-th best score is a lower bound on the final N-th best,
+        // so the largest one seen is a safe cut-off for everybody
+        double threshold() const { return threshold_.load(std::memory_order_relaxed); }
+        void raiseThreshold(double score) {
+            double current = threshold_.load(std::memory_order_relaxed);
+            while (score > current && !threshold_.compare_exchange_weak(current, score)) {}
+        }
+
+        void addPruned(size_t teams) { prunedTeams_.fetch_add(teams, std::memory_order_relaxed); }
+        size_t prunedTeams() const { return prunedTeams_.load(); }
+
+    private:
+        std::atomic<double> threshold_{-std::numeric_limits<double>::infinity()};
+        std::atomic<size_t> prunedTeams_{0};
+    };
+
+    // Early stopping and snapshots for one search. Workers pass their heap to checkpoint() every
+    // kProgressFlushInterval teams or so, and stop once it returns false. For snapshots, each
+    // worker stores its kept keys once per snapshot; whoever reaches a checkpoint when the next
+    // snapshot is due merges the stored keys and hands them to the callback.
+    class SearchMonitor {
+    public:
+        using Clock = std::chrono::steady_clock;
+        // Turns merged class-team keys into the teams a snapshot reports
+        using Finish = std::function<vector<ScoredTeam>(const TopTeams&)>;
+
+        SearchMonitor(const GeneratorOptions& options, size_t topN, Finish finish)
+            : cancellation_(options.cancellation), deadline_(options.deadline), onSnapshot_(options.onSnapshot),
+              interval_(options.snapshotInterval), topN_(topN), finish_(std::move(finish)),
+              nextSnapshot_(Clock::now() + options.snapshotInterval) {}
+
+        bool stopped() const { return stopped_.load(std::memory_order_relaxed); }
+
+        // False once the search should stop. Only TopTeams heaps take part in snapshots.
+        template <typename Collector>
+        bool checkpoint(const Collector& heap) {
+            if (stopped()) return false;
+            if ((cancellation_ && cancellation_->cancelled()) || (deadline_ != Clock::time_point::max() && Clock::now() >= deadline_)) {
+                stopped_.store(true, std::memory_order_relaxed);
+                return false;
+            }
+            if constexpr (std::is_same_v<Collector, TopTeams>) {
+                if (onSnapshot_) publish(heap);
+            }
+            return true;
         }
 
-        if (conflictRule == ConflictRule::TGOM_Ghost) {
-            // can have as many ghosts as you want
-            // can only have two non-ghosts max
-            size_t nonGhosts = 0;
-            for (const auto& member : team) {
-                const bool isGhost = 
-                    (member.primaryType == Type::Ghost) ||
-                    (member.secondaryType && *member.secondaryType == Type::Ghost);
+    private:
+        struct StoredKeys {
+            size_t snapshot = 0; // snapshotsTaken_ when stored
+            vector<RankKey> keys;
+        };
 
-                if (!isGhost) {
-                    if (++nonGhosts > 2) return true;
+        void publish(const TopTeams& heap) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            StoredKeys& stored = stored_[&heap];
+            if (stored.snapshot != snapshotsTaken_ || stored.keys.empty()) {
+                stored.snapshot = snapshotsTaken_;
+                stored.keys = heap.keys();
+            }
+            const auto now = Clock::now();
+            if (now < nextSnapshot_) return;
+
+            TopTeams merged(topN_);
+            for (const auto& [worker, workerKeys] : stored_) {
+                // Heuristic workers start from the same beam teams
+                for (const RankKey& key : workerKeys.keys) {
+                    if (!merged.contains(key)) merged.offer(key);
                 }
             }
+            onSnapshot_(finish_(merged));
+            ++snapshotsTaken_;
+            nextSnapshot_ = now + interval_;
         }
 
-        // Only one mega evolution allowed
-        bool seenMega = false;
-        for (const auto& member : team) {
-            if (isMega(member)) {
-                if (seenMega) return true;  // second mega found
-                seenMega = true;
+        const CancellationToken* cancellation_;
+        const Clock::time_point deadline_;
+        const std::function<void(const vector<ScoredTeam>&)>& onSnapshot_;
+        const std::chrono::milliseconds interval_;
+        const size_t topN_;
+        const Finish finish_;
+        std::atomic<bool> stopped_{false};
+
+        std::mutex mutex_; // guards the rest
+        std::unordered_map<const TopTeams*, StoredKeys> stored_;
+        size_t snapshotsTaken_ = 1;
+        Clock::time_point nextSnapshot_;
+    };
+
+    // The pool split into classes of interchangeable members: same types and mega status, so the
+    // same conflicts, and the same profile, so the same scores. The search runs over one
+    // representative per class, which may fill as many slots as its class has members, and
+    // only the reported teams are expanded back into named members.
+    struct MemberClasses {
+        PokemonList representatives;       // search roster: the pinned members, then one per class
+        MemberProfileTable profiles;       // per search-roster index
+        vector<vector<uint16_t>> members;  // per search-roster index: named-roster indices, ascending
+        vector<uint16_t> classOf;          // per named-roster index: search-roster index
+    };
+
+    bool isInterchangeable(const Pokemon& a, const MemberProfile& aProfile, const Pokemon& b, const MemberProfile& bProfile) {
+        return a.primaryType == b.primaryType && a.secondaryType == b.secondaryType && isMega(a) == isMega(b) &&
+            aProfile.coverage == bProfile.coverage && aProfile.defense.effectiveness == bProfile.defense.effectiveness;
+    }
+
+    // Groups the named roster (pinned members, then the name-sorted pool) into classes.
+    // Pinned members always stay on their own; without collapse every member does.
+    MemberClasses buildMemberClasses(
+        const PokemonList& namedRoster,
+        const MemberProfileTable& namedProfiles,
+        size_t pinnedCount,
+        bool collapse
+    ) {
+        MemberClasses classes;
+        classes.classOf.resize(namedRoster.size());
+        for (size_t index = 0; index < namedRoster.size(); ++index) {
+            size_t classIndex = classes.representatives.size();
+            if (collapse && index >= pinnedCount) {
+                for (size_t c = pinnedCount; c < classes.representatives.size(); ++c) {
+                    if (isInterchangeable(namedRoster[index], namedProfiles[index], classes.representatives[c], classes.profiles[c])) {
+                        classIndex = c;
+                        break;
+                    }
+                }
+            }
+            if (classIndex == classes.representatives.size()) {
+                classes.representatives.push_back(namedRoster[index]);
+                classes.profiles.push_back(namedProfiles[index]);
+                classes.members.emplace_back();
             }
+            classes.members[classIndex].push_back(static_cast<uint16_t>(index));
+            classes.classOf[index] = static_cast<uint16_t>(classIndex);
         }
+        return classes;
+    }
 
-        return false;
+    // The named team a class team stands for that wins the tie-breaker: greatest members first.
+    // Ranking class teams by it keeps exactly the top-N teams an uncollapsed search would.
+    TeamIndices bestNamedTeam(const MemberClasses& classes, const TeamIndices& team) {
+        TeamIndices named;
+        for (size_t slot = 0; slot < team.size(); ++slot) {
+            // Repeats of a class are adjacent; the j-th copy takes the j-th greatest member
+            size_t repeat = 0;
+            while (repeat < slot && team.slots[slot - 1 - repeat] == team.slots[slot]) ++repeat;
+            const auto& members = classes.members[team.slots[slot]];
+            named.push_back(members[members.size() - 1 - repeat]);
+        }
+        named.sort();
+        return named;
     }
 
-    // Push a scored team into the min-heap while keeping only topN teams
-    static void pushIfTop(
-        MinHeap& heap,
-        const ScoredTeam& sTeam,
-        size_t topN
+    // Immutable inputs shared by every worker of one generateTopTeams call.
+    // The roster holds the pinned members first, then one representative per pool class; teams are
+    // non-decreasing index arrays into it, with a class repeated at most once per member it has.
+    struct SearchContext {
+        const PokemonList& roster;
+        const MemberProfileTable& rosterProfiles;
+        const MemberClasses& classes;
+        const MultisetCounter& members; // copies of each roster index a team may hold (pinned: 0)
+        size_t pinnedCount;
+        const CoverageSet& pinnedCoverage;
+        const TeamDefense& pinnedDefense;
+        const ConflictState& pinnedConflicts;
+        const vector<ConflictState>& memberConflicts; // each roster member's own counters
+        size_t slotsToFill;
+        size_t topN;
+        const TeamEvaluator& evaluator;
+        const BatchEvaluator& batch; // over rosterProfiles
+        ConflictLimits conflictLimits;
+        RankingPolicy ranking; // per-team code runs on the withRanking specialization of it
+        SearchStrategy strategy;
+        // BranchAndBound only
+        const ScoreBounds* bounds;
+        BranchAndBoundShared* shared;
+        SearchMonitor* monitor;
+    };
+
+    // Whether a team (the pinned members first) breaks the conflict rule. Starts from the
+    // pinned members' counters and only adds the chosen ones.
+    bool hasConflict(const SearchContext& ctx, const TeamIndices& team) {
+        ConflictState state = ctx.pinnedConflicts;
+        for (size_t slot = ctx.pinnedCount; slot < team.size(); ++slot) {
+            state.merge(ctx.memberConflicts[team.slots[slot]]);
+        }
+        return state.conflicts(ctx.conflictLimits);
+    }
+
+    // Completed-team counter shared between workers. Workers add in batches and
+    // a progress line is logged whenever a report interval boundary is crossed.
+    class ProgressCounter {
+    public:
+        explicit ProgressCounter(size_t total) : total_(total) {}
+
+        void add(size_t count) {
+            if (count == 0) return;
+            const size_t after = completed_.fetch_add(count) + count;
+            const size_t before = after - count;
+            const size_t boundary = after - after % kProgressReportInterval;
+            if (boundary > before) TeamGenerator::reportProgress(boundary, total_);
+            if (after == total_ && boundary != after) TeamGenerator::reportProgress(after, total_);
+        }
+
+    private:
+        std::atomic<size_t> completed_{0};
+        const size_t total_;
+    };
+
+    // Offers one scored, conflict-free team to the heap (TopTeams, or ParetoFrontier). The named
+    // team it's ranked by is only built once the scores alone could place it.
+    template <typename Ranking, typename Collector>
+    void offerCandidate(
+        const SearchContext& ctx,
+        const Ranking& ranking,
+        const TeamIndices& team,
+        double offenseScore,
+        double defenseScore,
+        Collector& heap
     ) {
-        if (heap.size() < topN) {
-            heap.push(sTeam);
-        } else if (heap.top() < sTeam) {
-            heap.pop();
-            heap.push(sTeam);
+        if (defenseScore >= 0.0 && heap.couldAccept(ranking, offenseScore, defenseScore)) {
+            heap.offer(RankKey(ranking, offenseScore, defenseScore, bestNamedTeam(ctx.classes, team)));
         }
     }
 
-    // Collect heap contents into a sorted vector (descending), cap to topN
-    static vector<ScoredTeam> collectResultsFromHeap(
-        MinHeap& heap,
-        size_t topN
+    // Scores one complete, conflict-free team and offers it to the heap
+    template <typename Ranking, typename Collector>
+    void scoreCandidate(
+        const SearchContext& ctx,
+        const Ranking& ranking,
+        const TeamIndices& team,
+        const CoverageSet& teamCoverage,
+        const TeamDefense& teamDefense,
+        Collector& heap
     ) {
-        vector<ScoredTeam> allResults;
-        while (!heap.empty()) {
-            allResults.push_back(heap.top());
-            heap.pop();
+        offerCandidate(ctx, ranking, team, ctx.evaluator.evaluateOffense(teamCoverage), ctx.evaluator.evaluateDefense(teamDefense), heap);
+    }
+
+    // Collects complete teams, already checked for conflicts, that extend one base state (the
+    // members before firstSlot) and scores them kBatchSize at a time with the batch evaluator
+    template <typename Ranking, typename Collector>
+    class CandidateBatch {
+    public:
+        CandidateBatch(
+            const SearchContext& ctx,
+            const Ranking& ranking,
+            const CoverageSet& baseCoverage,
+            const TeamDefense& baseDefense,
+            size_t firstSlot,
+            Collector& heap
+        ) : ctx_(ctx), ranking_(ranking), baseCoverage_(baseCoverage), baseDefense_(baseDefense), firstSlot_(firstSlot), heap_(heap) {}
+
+        void add(const TeamIndices& team) {
+            teams_[count_++] = team;
+            if (count_ == kBatchSize) flush();
+        }
+
+        // Scores and offers the collected teams. Call once more after the last add.
+        void flush() {
+            if (count_ == 0) return;
+            ctx_.batch.score(baseCoverage_, baseDefense_, teams_.data(), count_, firstSlot_, scores_.data());
+            for (size_t i = 0; i < count_; ++i) {
+                offerCandidate(ctx_, ranking_, teams_[i], scores_[i].offense, scores_[i].defense, heap_);
+            }
+            count_ = 0;
+        }
+
+    private:
+        const SearchContext& ctx_;
+        const Ranking ranking_;
+        const CoverageSet& baseCoverage_;
+        const TeamDefense& baseDefense_;
+        size_t firstSlot_;
+        Collector& heap_;
+        std::array<TeamIndices, kBatchSize> teams_;
+        std::array<BatchScore, kBatchSize> scores_;
+        size_t count_ = 0;
+    };
+
+    // Where the completions of a prefix start: the last chosen class again while it has members
+    // left, otherwise the roster index after it
+    struct NextMember {
+        size_t first;
+        size_t copies; // copies of `first` still available
+    };
+
+    size_t copiesOf(const SearchContext& ctx, size_t index) {
+        return index < ctx.roster.size() ? ctx.members.capacity(index) : 0;
+    }
+
+    // Next member once `index` has been placed after a prefix whose next member was `next`
+    NextMember nextAfter(const SearchContext& ctx, const NextMember& next, size_t index) {
+        const size_t copies = (index == next.first) ? next.copies : copiesOf(ctx, index);
+        if (copies > 1) return {index, copies - 1};
+        return {index + 1, copiesOf(ctx, index + 1)};
+    }
+
+    NextMember nextMember(const SearchContext& ctx, const TeamIndices& prefix) {
+        NextMember next{ctx.pinnedCount, copiesOf(ctx, ctx.pinnedCount)};
+        for (size_t slot = ctx.pinnedCount; slot < prefix.size(); ++slot) {
+            next = nextAfter(ctx, next, prefix.slots[slot]);
         }
-        std::sort(allResults.begin(), allResults.end());
-        std::reverse(allResults.begin(), allResults.end());
-        if (allResults.size() > topN) allResults.resize(topN);
-        return allResults;
+        return next;
     }
 
-    // Generate, score, and filter teams on-the-fly
+    // Number of teams within the counted conflict limits that complete a prefix by placing
+    // `index` next, with `remaining` slots open and budgetLeft of the limits unspent
+    size_t completionsWith(
+        const SearchContext& ctx,
+        const NextMember& next,
+        size_t index,
+        size_t remaining,
+        const MultisetCounter::Resources& budgetLeft
+    ) {
+        const size_t copies = (index == next.first) ? next.copies : ctx.members.capacity(index);
+        if (copies == 0 || !ctx.members.affords(index, budgetLeft)) return 0;
+        return ctx.members.count(index, copies - 1, remaining - 1, ctx.members.spend(index, budgetLeft));
+    }
+
+    // Coverage, defense and conflict counters of the leading enumerated members, one level per
+    // slot: level d is the base state plus the first d members. After a step of the enumeration
+    // only the levels past its first changed slot are rebuilt, each from the level below with a
+    // single merge.
+    class PrefixStates {
+    public:
+        PrefixStates(
+            const SearchContext& ctx,
+            const CoverageSet& baseCoverage,
+            const TeamDefense& baseDefense,
+            const ConflictState& baseConflicts,
+            size_t levels
+        ) : ctx_(ctx), coverage_(levels, baseCoverage), defense_(levels, baseDefense), conflicts_(levels, baseConflicts) {}
+
+        size_t levels() const { return coverage_.size(); }
+        const CoverageSet& lastCoverage() const { return coverage_.back(); }
+        const TeamDefense& lastDefense() const { return defense_.back(); }
+        const ConflictState& lastConflicts() const { return conflicts_.back(); }
+
+        // Rebuilds the levels that depend on slots from changedSlot on. Stops at the first level
+        // whose members conflict and returns the slot of its last member, else levels().
+        size_t update(const vector<size_t>& indices, size_t changedSlot) {
+            for (size_t level = changedSlot + 1; level < levels(); ++level) {
+                const size_t index = indices[level - 1];
+                conflicts_[level] = conflicts_[level - 1];
+                conflicts_[level].merge(ctx_.memberConflicts[index]);
+                if (conflicts_[level].conflicts(ctx_.conflictLimits)) return level - 1;
+
+                const MemberProfile& member = ctx_.rosterProfiles[index];
+                coverage_[level] = coverage_[level - 1];
+                coverage_[level].merge(member.coverage);
+                defense_[level] = defense_[level - 1];
+                defense_[level].add(member.defense);
+            }
+            return levels();
+        }
+
+    private:
+        const SearchContext& ctx_;
+        vector<CoverageSet> coverage_;
+        vector<TeamDefense> defense_;
+        vector<ConflictState> conflicts_;
+    };
+
+    // Scores the completions of a prefix the enumerator walks, up to endRank. Every member but
+    // the last comes from the prefix levels; teams sharing them are batch-scored with the last
+    // member as the only slot to add. A level whose members conflict skips its whole subtree.
+    template <typename Ranking, typename Collector>
+    void scoreCompletions(
+        const SearchContext& ctx,
+        const Ranking& ranking,
+        const TeamIndices& prefix,
+        const CoverageSet& prefixCoverage,
+        const TeamDefense& prefixDefense,
+        const ConflictState& prefixConflicts,
+        MultisetEnumerator& combinations,
+        size_t endRank,
+        Collector& heap,
+        ProgressCounter& progress
+    ) {
+        if (prefixConflicts.conflicts(ctx.conflictLimits)) {
+            if (!combinations.done()) progress.add(std::min(combinations.total(), endRank) - combinations.rank());
+            return;
+        }
+
+        const size_t slots = ctx.slotsToFill - (prefix.size() - ctx.pinnedCount);
+        PrefixStates states(ctx, prefixCoverage, prefixDefense, prefixConflicts, std::max<size_t>(slots, 1));
+        CandidateBatch<Ranking, Collector> batch(ctx, ranking, states.lastCoverage(), states.lastDefense(), prefix.size() + states.levels() - 1, heap);
+        size_t pendingProgress = 0;
+        bool stopped = false;
+        auto countCompleted = [&](size_t count) {
+            pendingProgress += count;
+            if (pendingProgress >= kProgressFlushInterval) {
+                progress.add(pendingProgress);
+                pendingProgress = 0;
+                stopped = !ctx.monitor->checkpoint(heap);
+            }
+        };
+        while (!stopped && !combinations.done() && combinations.rank() < endRank) {
+            // The batch holds teams scored against the last level, so it's emptied before that changes
+            const size_t changedSlot = combinations.changedSlot();
+            if (changedSlot + 1 < states.levels()) {
+                batch.flush();
+                const size_t conflictSlot = states.update(combinations.indices(), changedSlot);
+                if (conflictSlot < states.levels()) {
+                    const size_t rank = combinations.rank();
+                    combinations.skip(conflictSlot);
+                    countCompleted(std::min(combinations.rank(), endRank) - rank);
+                    continue;
+                }
+            }
+            countCompleted(1);
+
+            ConflictState conflicts = states.lastConflicts();
+            if (slots > 0) conflicts.merge(ctx.memberConflicts[combinations.indices().back()]);
+            if (!conflicts.conflicts(ctx.conflictLimits)) {
+                TeamIndices currentTeam = prefix;
+                for (const size_t index : combinations.indices()) currentTeam.push_back(index);
+                batch.add(currentTeam);
+            }
+            combinations.next();
+        }
+        batch.flush();
+        progress.add(pendingProgress);
+    }
+
+    // Generate, score, and filter the teams with combination ranks in [beginRank, endRank) on-the-fly
+    template <typename Collector>
     void processCombinationsAndUpdateHeap(
-        const PokemonList& sortedMembers,
-        size_t slotsToFill,
-        size_t topN,
-        const TeamEvaluator& evaluator,
-        const TypeAbilityComboList& targets,
-        MinHeap& heap,
-        size_t& completedTeams,
-        size_t totalTeams,
-        const Team& pinnedMembers,
-        const ConflictRule& conflictRule
+        const SearchContext& ctx,
+        size_t beginRank,
+        size_t endRank,
+        Collector& heap,
+        ProgressCounter& progress
     ) {
-        vector<bool> selectMask(sortedMembers.size(), false);
-        std::fill(selectMask.end() - slotsToFill, selectMask.end(), true);
-        do {
-            Team currentTeam = pinnedMembers;
-            for (size_t i = 0; i < sortedMembers.size(); ++i) {
-                if (selectMask[i]) {
-                    currentTeam.push_back(sortedMembers[i]);
+        TeamIndices pinnedIndices;
+        for (size_t i = 0; i < ctx.pinnedCount; ++i) pinnedIndices.push_back(i);
+
+        // Pinned members have no copies to give, so the enumerated indices are roster indices
+        MultisetEnumerator combinations(ctx.members, ctx.slotsToFill, beginRank);
+        withRanking(ctx.ranking, [&](const auto& ranking) {
+            scoreCompletions(ctx, ranking, pinnedIndices, ctx.pinnedCoverage, ctx.pinnedDefense, ctx.pinnedConflicts,
+                combinations, endRank, heap, progress);
+        });
+    }
+
+    // Depth-first search below a prefix that skips every subtree whose optimistic bound can't
+    // reach the current N-th best team. At each node every candidate member's gain against the
+    // prefix is computed once; a child is cut when the prefix score plus its own gain plus the
+    // best gains of the members that could follow it falls short. Nodes one member from complete
+    // reuse their parent's gains, so leaves are filtered without merging their profiles.
+    // Per-depth scratch states keep the descent allocation free.
+    // Filling a ParetoFrontier, the search runs on OffenseRanking so the combined bound is the
+    // offense bound, and a child is cut when the frontier dominates its offense and defense bounds.
+    template <typename Ranking, typename Collector>
+    class BranchAndBoundSearch {
+    public:
+        BranchAndBoundSearch(const SearchContext& ctx, const Ranking& ranking, Collector& heap, ProgressCounter& progress)
+            : ctx_(ctx), ranking_(ranking), heap_(heap), progress_(progress),
+              coverage_(ctx.slotsToFill + 1, ctx.pinnedCoverage),
+              defense_(ctx.slotsToFill + 1, ctx.pinnedDefense),
+              conflicts_(ctx.slotsToFill + 1, ctx.pinnedConflicts),
+              bonus_(ctx.slotsToFill + 1),
+              gain_(ctx.slotsToFill + 1, vector<double>(ctx.roster.size())),
+              defenseGain_(ctx.slotsToFill + 1, vector<double>(ctx.roster.size())),
+              rest_(ctx.slotsToFill + 1, vector<double>(ctx.roster.size())),
+              defenseRest_(ctx.slotsToFill + 1, vector<double>(ctx.roster.size())) {}
+
+        void run(const TeamIndices& prefix) {
+            if (ctx_.monitor->stopped()) return;
+            team_ = prefix;
+            const size_t chosen = prefix.size() - ctx_.pinnedCount;
+            coverage_[chosen] = ctx_.pinnedCoverage;
+            defense_[chosen] = ctx_.pinnedDefense;
+            conflicts_[chosen] = ctx_.pinnedConflicts;
+            for (size_t slot = ctx_.pinnedCount; slot < prefix.size(); ++slot) {
+                coverage_[chosen].merge(ctx_.rosterProfiles[prefix.slots[slot]].coverage);
+                defense_[chosen].add(ctx_.rosterProfiles[prefix.slots[slot]].defense);
+                conflicts_[chosen].merge(ctx_.memberConflicts[prefix.slots[slot]]);
+            }
+
+            const NextMember next = nextMember(ctx_, prefix);
+            if (!conflicts_[chosen].conflicts(ctx_.conflictLimits)) {
+                descend(chosen, next, false);
+            } else {
+                const auto budgetLeft = conflictBudget(ctx_.conflictLimits, conflicts_[chosen]);
+                skip(ctx_.members.count(next.first, next.copies, ctx_.slotsToFill - chosen, budgetLeft));
+            }
+            progress_.add(pendingProgress_);
+            pendingProgress_ = 0;
+        }
+
+    private:
+        void descend(size_t chosen, const NextMember& next, bool hasParentGains) {
+            if (chosen == ctx_.slotsToFill) {
+                scoreCandidate(ctx_, ranking_, team_, coverage_[chosen], defense_[chosen], heap_);
+                if constexpr (std::is_same_v<Collector, TopTeams>) {
+                    if (heap_.full()) ctx_.shared->raiseThreshold(heap_.worst().combinedScore());
                 }
+                countCompleted(1);
+                return;
             }
-            if (currentTeam.size() != pinnedMembers.size() + slotsToFill) continue;
-            
-            // Skip teams with conflicts
-            if (hasConflict(currentTeam, conflictRule)) {
-                ++completedTeams;
-                TeamGenerator::reportProgress(completedTeams, totalTeams);
-                continue;
+
+            const size_t remaining = ctx_.slotsToFill - chosen;
+            const double defenseScore = defense_[chosen].score();
+            const double score = ranking_.combine(static_cast<double>(coverage_[chosen].count()), defenseScore);
+            bonus_[chosen] = ScoreBounds::prefixBonus(defense_[chosen]);
+
+            // Gains against this prefix, or the parent's gains widened by the bonus this prefix lost
+            const vector<double>* gain = &gain_[chosen];
+            const vector<double>* defenseGain = &defenseGain_[chosen];
+            double slack = 0.0;
+            if (remaining == 1 && hasParentGains) {
+                gain = &gain_[chosen - 1];
+                defenseGain = &defenseGain_[chosen - 1];
+                slack = ScoreBounds::ancestorSlack(bonus_[chosen - 1], bonus_[chosen]);
+            } else {
+                const vector<size_t>& copies = ctx_.members.capacities();
+                ctx_.bounds->memberGains(coverage_[chosen], bonus_[chosen], next.first, gain_[chosen], defenseGain_[chosen]);
+                bestFollowingSums(gain_[chosen], copies, next.first, next.copies, remaining - 1, rest_[chosen]);
+                bestFollowingSums(defenseGain_[chosen], copies, next.first, next.copies, remaining - 1, defenseRest_[chosen]);
             }
+            const double combinedSlack = ranking_.combine(0.0, slack) * remaining;
+            const double defenseSlack = slack * remaining;
+            const bool inherited = (gain != &gain_[chosen]);
 
-            double offenseScore = evaluator.evaluateOffense(currentTeam, targets);
-            double defenseScore = evaluator.evaluateDefense(currentTeam, TypeUtils::all());
-            if (defenseScore >= 0.0) {
-                ScoredTeam sTeam{currentTeam, offenseScore, defenseScore};
-                pushIfTop(heap, sTeam, topN);
+            // Members past the counted limits have no completions and aren't part of the search
+            const auto budgetLeft = conflictBudget(ctx_.conflictLimits, conflicts_[chosen]);
+            for (size_t index = next.first; index < ctx_.roster.size() && !stopped_; ++index) {
+                const size_t subtreeTeams = completionsWith(ctx_, next, index, remaining, budgetLeft);
+                if (subtreeTeams == 0) continue;
+                // Type overlap isn't counted, and conflicts only grow as members are added
+                conflicts_[chosen + 1] = conflicts_[chosen];
+                conflicts_[chosen + 1].merge(ctx_.memberConflicts[index]);
+                if (conflicts_[chosen + 1].conflicts(ctx_.conflictLimits)) {
+                    skip(subtreeTeams);
+                    continue;
+                }
+                const double restGain = inherited ? 0.0 : rest_[chosen][index];
+                const double restDefenseGain = inherited ? 0.0 : defenseRest_[chosen][index];
+                const double defenseBound = defenseScore + (*defenseGain)[index] + restDefenseGain + defenseSlack;
+
+                // Every completion would be filtered out by the defense >= 0 rule
+                if (defenseBound < 0.0) {
+                    skip(subtreeTeams);
+                    continue;
+                }
+                if (cannotPlace(score + (*gain)[index] + restGain + combinedSlack, defenseBound)) {
+                    skip(subtreeTeams);
+                    continue;
+                }
+
+                team_.push_back(index);
+                coverage_[chosen + 1] = coverage_[chosen];
+                coverage_[chosen + 1].merge(ctx_.rosterProfiles[index].coverage);
+                defense_[chosen + 1] = defense_[chosen];
+                defense_[chosen + 1].add(ctx_.rosterProfiles[index].defense);
+                descend(chosen + 1, nextAfter(ctx_, next, index), true);
+                team_.pop_back();
             }
-            ++completedTeams;
-            TeamGenerator::reportProgress(completedTeams, totalTeams);
-        } while (std::next_permutation(selectMask.begin(), selectMask.end()));
+        }
+
+        // Ties can still win on the tie-breaker, so only a strictly lower bound is pruned. The combined
+        // bound sums separately rounded combine() gains and can sit an ulp under the team's own score.
+        bool cannotPlace(double combinedBound, double defenseBound) const {
+            if constexpr (std::is_same_v<Collector, ParetoFrontier>) {
+                static_assert(std::is_same_v<Ranking, OffenseRanking>, "Frontier bounds need the offense bound on its own");
+                return heap_.dominated(combinedBound, defenseBound);
+            } else {
+                double threshold = ctx_.shared->threshold();
+                if (heap_.full()) threshold = std::max(threshold, heap_.worst().combinedScore());
+                return combinedBound + kBoundTolerance * std::max(1.0, std::abs(combinedBound)) < threshold;
+            }
+        }
+
+        void skip(size_t teams) {
+            ctx_.shared->addPruned(teams);
+            countCompleted(teams);
+        }
+
+        void countCompleted(size_t teams) {
+            pendingProgress_ += teams;
+            if (pendingProgress_ >= kProgressFlushInterval) {
+                progress_.add(pendingProgress_);
+                pendingProgress_ = 0;
+                stopped_ = !ctx_.monitor->checkpoint(heap_);
+            }
+        }
+
+        const SearchContext& ctx_;
+        const Ranking ranking_;
+        Collector& heap_;
+        ProgressCounter& progress_;
+        TeamIndices team_;
+        // Scratch state indexed by chosen-member depth
+        vector<CoverageSet> coverage_;
+        vector<TeamDefense> defense_;
+        vector<ConflictState> conflicts_;
+        vector<BonusVector> bonus_;
+        vector<vector<double>> gain_;         // per roster index: bound on combined score gain
+        vector<vector<double>> defenseGain_;  // per roster index: bound on defensive score gain
+        vector<vector<double>> rest_;         // best gains of the members that can follow
+        vector<vector<double>> defenseRest_;
+        size_t pendingProgress_ = 0;
+        bool stopped_ = false;
+    };
+
+    // Warm start for branch and bound: greedily completes a team from every pool member and
+    // returns the N-th best distinct valid result. Those teams exist in the search space, so the
+    // final N-th best can't score lower, and pruning starts from a useful cut-off immediately.
+    double greedyThreshold(const SearchContext& ctx) {
+        const double none = -std::numeric_limits<double>::infinity();
+        if (ctx.slotsToFill == 0) return none;
+
+        std::set<std::array<uint16_t, kMaxTeamSize>> seen;
+        vector<double> scores;
+        CoverageSet coverage = ctx.pinnedCoverage;
+        TeamDefense defense = ctx.pinnedDefense;
+        for (size_t seed = ctx.pinnedCount; seed < ctx.roster.size(); ++seed) {
+            TeamIndices team;
+            for (size_t i = 0; i < ctx.pinnedCount; ++i) team.push_back(i);
+            team.push_back(seed);
+            coverage = ctx.pinnedCoverage;
+            coverage.merge(ctx.rosterProfiles[seed].coverage);
+            defense = ctx.pinnedDefense;
+            defense.add(ctx.rosterProfiles[seed].defense);
+            if (hasConflict(ctx, team)) continue;
+
+            while (team.size() < ctx.pinnedCount + ctx.slotsToFill) {
+                size_t bestIndex = 0;
+                double bestScore = none;
+                for (size_t index = ctx.pinnedCount; index < ctx.roster.size(); ++index) {
+                    if (std::find(team.begin(), team.end(), index) != team.end()) continue;
+                    team.push_back(index);
+                    if (!hasConflict(ctx, team)) {
+                        TeamDefense next = defense;
+                        next.add(ctx.rosterProfiles[index].defense);
+                        const double score = ctx.ranking.combine(
+                            static_cast<double>(coverage.countUnion(ctx.rosterProfiles[index].coverage)), next.score());
+                        if (score > bestScore) {
+                            bestScore = score;
+                            bestIndex = index;
+                        }
+                    }
+                    team.pop_back();
+                }
+                if (bestScore == none) break;
+                team.push_back(bestIndex);
+                coverage.merge(ctx.rosterProfiles[bestIndex].coverage);
+                defense.add(ctx.rosterProfiles[bestIndex].defense);
+            }
+            if (team.size() < ctx.pinnedCount + ctx.slotsToFill || defense.score() < 0.0) continue;
+
+            team.sort(ctx.pinnedCount);
+            if (!seen.insert(team.slots).second) continue;
+            scores.push_back(ctx.ranking.combine(ctx.evaluator.evaluateOffense(coverage), ctx.evaluator.evaluateDefense(defense)));
+        }
+
+        if (ctx.topN == 0 || scores.size() < ctx.topN) return none;
+        std::nth_element(scores.begin(), scores.begin() + (ctx.topN - 1), scores.end(), std::greater<double>());
+        return scores[ctx.topN - 1];
+    }
+
+    // Evaluations and wall-clock time one heuristic worker may spend. The clock checks are also the
+    // worker's checkpoints with the search monitor, for the heap it fills.
+    class SearchBudget {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        SearchBudget(size_t evaluations, Clock::time_point deadline, SearchMonitor& monitor, const TopTeams& heap)
+            : limit_(evaluations), deadline_(deadline), monitor_(&monitor), heap_(&heap) {}
+
+        // Takes one evaluation; false once either budget is spent or the search is stopped
+        bool spend() {
+            if (spent_) return false;
+            if (used_ == limit_ ||
+                (used_ % kClockCheckInterval == 0 && (Clock::now() >= deadline_ || !monitor_->checkpoint(*heap_)))) {
+                spent_ = true;
+                return false;
+            }
+            ++used_;
+            return true;
+        }
+        size_t used() const { return used_; }
+
+    private:
+        size_t limit_;
+        Clock::time_point deadline_;
+        SearchMonitor* monitor_;
+        const TopTeams* heap_;
+        size_t used_ = 0;
+        bool spent_ = false;
+    };
+
+    // Offense and defense of a team (the pinned members first), merged onto the pinned members' state
+    std::pair<double, double> scoreTeam(const SearchContext& ctx, const TeamIndices& team) {
+        CoverageSet coverage = ctx.pinnedCoverage;
+        TeamDefense defense = ctx.pinnedDefense;
+        for (size_t slot = ctx.pinnedCount; slot < team.size(); ++slot) {
+            coverage.merge(ctx.rosterProfiles[team.slots[slot]].coverage);
+            defense.add(ctx.rosterProfiles[team.slots[slot]].defense);
+        }
+        return {ctx.evaluator.evaluateOffense(coverage), ctx.evaluator.evaluateDefense(defense)};
+    }
+
+    // offerCandidate for searches that may score a team again: a team already kept isn't added twice
+    void offerDistinct(const SearchContext& ctx, const TeamIndices& team, double offenseScore, double defenseScore, TopTeams& heap) {
+        if (defenseScore >= 0.0 && heap.couldAccept(ctx.ranking, offenseScore, defenseScore)) {
+            const RankKey key(ctx.ranking, offenseScore, defenseScore, bestNamedTeam(ctx.classes, team));
+            if (!heap.contains(key)) heap.offer(key);
+        }
+    }
+
+    // Whether one more copy of a roster index fits a team
+    bool hasCopyLeft(const SearchContext& ctx, const TeamIndices& team, size_t index) {
+        const size_t held = static_cast<size_t>(std::count(team.begin(), team.end(), index));
+        return held < ctx.members.capacities()[index];
+    }
+
+    // Builds teams one slot at a time, keeping the beamWidth best conflict-free partial teams by
+    // the ranking. Complete teams are offered to the heap. Returns the last beam, best first.
+    vector<TeamIndices> beamSearch(const SearchContext& ctx, size_t beamWidth, SearchBudget& budget, TopTeams& heap) {
+        TeamIndices pinnedIndices;
+        for (size_t i = 0; i < ctx.pinnedCount; ++i) pinnedIndices.push_back(i);
+        vector<TeamIndices> beam{pinnedIndices};
+        if (ctx.slotsToFill == 0) {
+            if (budget.spend()) {
+                const auto [offense, defense] = scoreTeam(ctx, pinnedIndices);
+                offerCandidate(ctx, ctx.ranking, pinnedIndices, offense, defense, heap);
+            }
+            return beam;
+        }
+
+        for (size_t chosen = 0; chosen < ctx.slotsToFill; ++chosen) {
+            const bool complete = (chosen + 1 == ctx.slotsToFill);
+            TopTeams next(beamWidth);
+            // Teams are kept sorted, so the same team reached from two parents is scored once
+            std::set<std::array<uint16_t, kMaxTeamSize>> seen;
+            bool spent = false;
+            for (size_t b = 0; b < beam.size() && !spent; ++b) {
+                for (size_t index = ctx.pinnedCount; index < ctx.roster.size(); ++index) {
+                    if (!hasCopyLeft(ctx, beam[b], index)) continue;
+                    TeamIndices child = beam[b];
+                    child.push_back(index);
+                    child.sort(ctx.pinnedCount);
+                    if (!seen.insert(child.slots).second || hasConflict(ctx, child)) continue;
+                    if (!budget.spend()) {
+                        spent = true;
+                        break;
+                    }
+                    const auto [offense, defense] = scoreTeam(ctx, child);
+                    if (complete) offerCandidate(ctx, ctx.ranking, child, offense, defense, heap);
+                    next.offer(RankKey(ctx.ranking, offense, defense, child));
+                }
+            }
+            // A level cut short leaves no complete teams to refine
+            if (next.empty() || (spent && !complete)) return {};
+            beam.clear();
+            for (const auto& team : next.results()) beam.push_back(team.members);
+        }
+        return beam;
+    }
+
+    // Simulated annealing over single-member swaps. Each chain starts from the next of the given
+    // teams (complete and conflict-free), cools geometrically over kAnnealingChainLength proposed
+    // swaps and offers every team it scores to the heap; chains repeat until the budget is spent.
+    // Every proposal takes one evaluation, whether or not the swap is valid.
+    void anneal(
+        const SearchContext& ctx,
+        const vector<TeamIndices>& starts,
+        size_t firstStart,
+        uint64_t seed,
+        SearchBudget& budget,
+        TopTeams& heap
+    ) {
+        if (starts.empty() || ctx.slotsToFill == 0 || ctx.roster.size() == ctx.pinnedCount) return;
+        std::mt19937_64 random(seed);
+        std::uniform_int_distribution<size_t> slotOf(ctx.pinnedCount, ctx.pinnedCount + ctx.slotsToFill - 1);
+        std::uniform_int_distribution<size_t> memberOf(ctx.pinnedCount, ctx.roster.size() - 1);
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+        const double startTemperature = ctx.ranking.combine(kStartTemperature, kStartTemperature / 4.0);
+        const double cooling = std::pow(1e-3, 1.0 / kAnnealingChainLength);
+
+        for (size_t chain = firstStart;; ++chain) {
+            TeamIndices team = starts[chain % starts.size()];
+            const auto [startOffense, startDefense] = scoreTeam(ctx, team);
+            double score = ctx.ranking.combine(startOffense, startDefense);
+            double temperature = startTemperature;
+            for (size_t step = 0; step < kAnnealingChainLength; ++step, temperature *= cooling) {
+                // Rejected swaps take budget too, so a pool with no valid swap still runs out of it
+                if (!budget.spend()) return;
+                const size_t slot = slotOf(random);
+                const size_t index = memberOf(random);
+                if (index == team.slots[slot]) continue;
+                // The swapped-out member is another one, so the team needs a copy of index to spare
+                if (!hasCopyLeft(ctx, team, index)) continue;
+                TeamIndices candidate = team;
+                candidate.slots[slot] = index;
+                candidate.sort(ctx.pinnedCount);
+                if (hasConflict(ctx, candidate)) continue;
+
+                const auto [offense, defense] = scoreTeam(ctx, candidate);
+                offerDistinct(ctx, candidate, offense, defense, heap);
+                const double candidateScore = ctx.ranking.combine(offense, defense);
+                const double delta = candidateScore - score;
+                if (delta >= 0.0 || (temperature > 0.0 && chance(random) < std::exp(delta / temperature))) {
+                    team = candidate;
+                    score = candidateScore;
+                }
+            }
+        }
+    }
+
+    // Optimistic combined score of any team. Over the pool members a team can start from, the best
+    // sum of slotsToFill members' gains against the pinned members alone (see ScoreBounds) bounds
+    // it, and so does full coverage of the targets with the best sum of defense gains.
+    double scoreUpperBound(const SearchContext& ctx) {
+        const double pinnedDefense = ctx.pinnedDefense.score();
+        const double pinnedScore = ctx.ranking.combine(static_cast<double>(ctx.pinnedCoverage.count()), pinnedDefense);
+        if (ctx.slotsToFill == 0) return pinnedScore;
+
+        const vector<size_t>& copies = ctx.members.capacities();
+        vector<double> gain(ctx.roster.size());
+        vector<double> defenseGain(ctx.roster.size());
+        vector<double> rest(ctx.roster.size());
+        vector<double> defenseRest(ctx.roster.size());
+        ctx.bounds->memberGains(ctx.pinnedCoverage, ScoreBounds::prefixBonus(ctx.pinnedDefense), ctx.pinnedCount, gain, defenseGain);
+        bestFollowingSums(gain, copies, ctx.pinnedCount, copies[ctx.pinnedCount], ctx.slotsToFill - 1, rest);
+        bestFollowingSums(defenseGain, copies, ctx.pinnedCount, copies[ctx.pinnedCount], ctx.slotsToFill - 1, defenseRest);
+        double bestGain = -std::numeric_limits<double>::infinity();
+        double bestDefenseGain = -std::numeric_limits<double>::infinity();
+        for (size_t index = ctx.pinnedCount; index < ctx.roster.size(); ++index) {
+            if (copies[index] == 0 || rest[index] == std::numeric_limits<double>::lowest()) continue;
+            bestGain = std::max(bestGain, gain[index] + rest[index]);
+            bestDefenseGain = std::max(bestDefenseGain, defenseGain[index] + defenseRest[index]);
+        }
+        const double fullCoverage = ctx.ranking.combine(static_cast<double>(ctx.pinnedCoverage.size()), pinnedDefense + bestDefenseGain);
+        return std::min(pinnedScore + bestGain, fullCoverage);
+    }
+
+    // Runs the heuristic search into the heap: the beam once, then one annealing chain per thread
+    // from its teams, each with an equal share of the evaluations the beam left
+    HeuristicStats runHeuristic(const SearchContext& ctx, const HeuristicOptions& options, size_t threadCount, TopTeams& heap) {
+        const auto deadline = (options.timeBudget.count() > 0)
+            ? SearchBudget::Clock::now() + options.timeBudget
+            : SearchBudget::Clock::time_point::max();
+        const size_t evaluations = (options.evaluationBudget > 0) ? options.evaluationBudget : std::numeric_limits<size_t>::max();
+
+        // The beam takes at most half an evaluation budget, so it completes and annealing has teams left to refine
+        size_t beamWidth = options.beamWidth;
+        if (options.evaluationBudget > 0) {
+            const size_t perBeamTeam = std::max<size_t>(1, (ctx.roster.size() - ctx.pinnedCount) * ctx.slotsToFill);
+            beamWidth = std::max<size_t>(1, std::min(beamWidth, options.evaluationBudget / 2 / perBeamTeam));
+        }
+        SearchBudget beamBudget(evaluations, deadline, *ctx.monitor, heap);
+        const vector<TeamIndices> beam = beamSearch(ctx, beamWidth, beamBudget, heap);
+        HeuristicStats stats;
+        stats.evaluations = beamBudget.used();
+
+        const size_t left = evaluations - beamBudget.used();
+        vector<TopTeams> workerHeaps(threadCount, heap);
+        vector<SearchBudget> budgets;
+        for (size_t t = 0; t < threadCount; ++t) {
+            const size_t share = (evaluations == std::numeric_limits<size_t>::max())
+                ? evaluations : left / threadCount + (t < left % threadCount ? 1 : 0);
+            budgets.emplace_back(share, deadline, *ctx.monitor, workerHeaps[t]);
+        }
+        vector<std::thread> workers;
+        workers.reserve(threadCount);
+        for (size_t t = 0; t < threadCount; ++t) {
+            workers.emplace_back([&ctx, &beam, &options, &budgets, &workerHeaps, t]() {
+                anneal(ctx, beam, t, options.seed + t, budgets[t], workerHeaps[t]);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        for (size_t t = 0; t < threadCount; ++t) {
+            // Workers may have found the same teams
+            for (const RankKey& key : workerHeaps[t].keys()) {
+                if (!heap.contains(key)) heap.offer(key);
+            }
+            stats.evaluations += budgets[t].used();
+        }
+
+        if (!heap.empty()) {
+            const ScoredTeam best = heap.results().front();
+            stats.bestScore = ctx.ranking.combine(best.offensiveScore, best.defensiveScore);
+        }
+        stats.upperBound = scoreUpperBound(ctx);
+        return stats;
+    }
+
+    // Scores every team that extends a prefix (roster indices: the pinned members, then
+    // ascending pool members) with pool members after the prefix's last one.
+    template <typename Collector>
+    void processPrefix(
+        const SearchContext& ctx,
+        const TeamIndices& prefix,
+        Collector& heap,
+        ProgressCounter& progress
+    ) {
+        if (ctx.strategy == SearchStrategy::BranchAndBound) {
+            if constexpr (std::is_same_v<Collector, ParetoFrontier>) {
+                BranchAndBoundSearch<OffenseRanking, Collector>(ctx, OffenseRanking{}, heap, progress).run(prefix);
+            } else {
+                withRanking(ctx.ranking, [&](const auto& ranking) {
+                    using Ranking = std::decay_t<decltype(ranking)>;
+                    BranchAndBoundSearch<Ranking, Collector>(ctx, ranking, heap, progress).run(prefix);
+                });
+            }
+            return;
+        }
+
+        CoverageSet prefixCoverage = ctx.pinnedCoverage;
+        TeamDefense prefixDefense = ctx.pinnedDefense;
+        ConflictState prefixConflicts = ctx.pinnedConflicts;
+        for (size_t slot = ctx.pinnedCount; slot < prefix.size(); ++slot) {
+            prefixCoverage.merge(ctx.rosterProfiles[prefix.slots[slot]].coverage);
+            prefixDefense.add(ctx.rosterProfiles[prefix.slots[slot]].defense);
+            prefixConflicts.merge(ctx.memberConflicts[prefix.slots[slot]]);
+        }
+
+        const size_t chosen = prefix.size() - ctx.pinnedCount;
+        const NextMember next = nextMember(ctx, prefix);
+
+        MultisetEnumerator combinations(ctx.members, next.first, next.copies, ctx.slotsToFill - chosen,
+            conflictBudget(ctx.conflictLimits, prefixConflicts));
+        withRanking(ctx.ranking, [&](const auto& ranking) {
+            scoreCompletions(ctx, ranking, prefix, prefixCoverage, prefixDefense, prefixConflicts, combinations,
+                combinations.total(), heap, progress);
+        });
+    }
+
+    // Splits the rank space into one contiguous range per worker. Each worker fills its own
+    // heap, a copy of the still-empty result; the heaps are merged afterwards. The ranking is a
+    // strict total order, so the merged result is exactly the serial one regardless of how the ranges were split.
+    template <typename Collector>
+    void processCombinationsInParallel(
+        const SearchContext& ctx,
+        size_t totalTeams,
+        size_t threadCount,
+        Collector& heap,
+        ProgressCounter& progress
+    ) {
+        vector<Collector> workerHeaps(threadCount, heap);
+        vector<std::thread> workers;
+        workers.reserve(threadCount);
+        for (size_t t = 0; t < threadCount; ++t) {
+            const size_t beginRank = totalTeams / threadCount * t + std::min(t, totalTeams % threadCount);
+            const size_t endRank = beginRank + totalTeams / threadCount + (t < totalTeams % threadCount ? 1 : 0);
+            workers.emplace_back([&ctx, &workerHeaps, &progress, t, beginRank, endRank]() {
+                processCombinationsAndUpdateHeap(ctx, beginRank, endRank, workerHeaps[t], progress);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        for (const auto& workerHeap : workerHeaps) heap.merge(workerHeap);
+    }
+
+    // Queues a task for a prefix. Prefixes shallower than splitDepth fan out into one child
+    // task per next member; deeper ones enumerate their completions directly.
+    template <typename Collector>
+    void schedulePrefix(
+        WorkStealingScheduler& scheduler,
+        size_t workerId,
+        const SearchContext& ctx,
+        const TeamIndices& prefix,
+        size_t splitDepth,
+        vector<Collector>& workerHeaps,
+        ProgressCounter& progress
+    ) {
+        auto task = [&scheduler, &ctx, prefix, splitDepth, &workerHeaps, &progress](size_t worker) {
+            if (ctx.monitor->stopped()) return;
+            const size_t chosen = prefix.size() - ctx.pinnedCount;
+            if (chosen >= splitDepth || chosen >= ctx.slotsToFill) {
+                processPrefix(ctx, prefix, workerHeaps[worker], progress);
+                return;
+            }
+            const NextMember next = nextMember(ctx, prefix);
+            ConflictState prefixConflicts = ctx.pinnedConflicts;
+            for (size_t slot = ctx.pinnedCount; slot < prefix.size(); ++slot) {
+                prefixConflicts.merge(ctx.memberConflicts[prefix.slots[slot]]);
+            }
+            const auto budgetLeft = conflictBudget(ctx.conflictLimits, prefixConflicts);
+            for (size_t index = next.first; index < ctx.roster.size(); ++index) {
+                if (completionsWith(ctx, next, index, ctx.slotsToFill - chosen, budgetLeft) == 0) continue;
+                TeamIndices child = prefix;
+                child.push_back(index);
+                schedulePrefix(scheduler, worker, ctx, child, splitDepth, workerHeaps, progress);
+            }
+        };
+        scheduler.spawn(workerId, std::move(task));
+    }
+
+    // Runs the search as prefix tasks on a work-stealing pool, one heap per worker, each a copy
+    // of the still-empty result
+    template <typename Collector>
+    SchedulerStats processCombinationsWorkStealing(
+        const SearchContext& ctx,
+        size_t threadCount,
+        size_t splitDepth,
+        Collector& heap,
+        ProgressCounter& progress
+    ) {
+        WorkStealingScheduler scheduler(threadCount);
+        vector<Collector> workerHeaps(threadCount, heap);
+
+        TeamIndices pinnedIndices;
+        for (size_t i = 0; i < ctx.pinnedCount; ++i) pinnedIndices.push_back(i);
+        scheduler.submit([&](size_t worker) {
+            schedulePrefix(scheduler, worker, ctx, pinnedIndices, splitDepth, workerHeaps, progress);
+        });
+        scheduler.run();
+
+        for (const auto& workerHeap : workerHeaps) heap.merge(workerHeap);
+        return scheduler.stats();
     }
 
-    vector<ScoredTeam> getTopNTeams(const vector<ScoredTeam>& scoredTeams, size_t topN) {
-        MinHeap heap;
-        for (const auto& sTeam : scoredTeams) {
-            pushIfTop(heap, sTeam, topN);
+    void addExpansions(
+        const RankKey& classTeam,
+        const vector<vector<TeamIndices>>& choices,
+        size_t depth,
+        size_t budget,
+        const TeamIndices& named,
+        TopTeams& namedTeams,
+        size_t topN
+    ) {
+        if (depth == choices.size()) {
+            TeamIndices members = named;
+            members.sort();
+            namedTeams.offer(classTeam.withMembers(members));
+            return;
+        }
+        for (size_t i = 0; i < choices[depth].size() && i + 1 <= budget; ++i) {
+            TeamIndices next = named;
+            for (const auto index : choices[depth][i]) next.push_back(index);
+            addExpansions(classTeam, choices, depth + 1, budget / (i + 1), next, namedTeams, topN);
         }
-        auto allResults = collectResultsFromHeap(heap, topN);
-        Logger::info("Team generation complete. Results: " + to_string(allResults.size()));
-        return allResults;
     }
 
-    size_t binomial_coefficient(size_t n, size_t k) {
-        if (k > n) return 0;
-        if (k == 0 || k == n) return 1;
-        if (k > n - k) k = n - k;
-        size_t result = 1;
-        for (size_t i = 1; i <= k; ++i) {
-            result = result * (n - k + i) / i;
+    // Replaces every class team by the named teams it stands for, keeping the top-N. Siblings tie on
+    // score, and a lexicographically greater member subset of one class always makes a greater team,
+    // so each class lists its subsets best first. A team built from the i1-th, i2-th, ... subsets is
+    // beaten by (i1 + 1)(i2 + 1)... - 1 of its siblings, which bounds how many need to be built.
+    void expandClassTeams(const MemberClasses& classes, const TopTeams& classTeams, TopTeams& namedTeams, size_t topN) {
+        for (const RankKey& classTeam : classTeams.keys()) {
+            // Copies of each class, in the order its named members appear
+            vector<std::pair<size_t, size_t>> classCopies;
+            for (const auto index : classTeam.members()) {
+                const size_t classIndex = classes.classOf[index];
+                auto it = std::find_if(classCopies.begin(), classCopies.end(),
+                    [classIndex](const std::pair<size_t, size_t>& entry) { return entry.first == classIndex; });
+                if (it == classCopies.end()) classCopies.emplace_back(classIndex, 1);
+                else ++it->second;
+            }
+
+            vector<vector<TeamIndices>> choices;
+            for (const auto& [classIndex, copies] : classCopies) {
+                const auto& members = classes.members[classIndex];
+                const size_t subsets = binomialCoefficient(members.size(), copies);
+                choices.emplace_back();
+                for (size_t rank = subsets; rank-- > 0 && choices.back().size() < topN;) {
+                    TeamIndices subset;
+                    for (const size_t position : CombinationEnumerator::unrank(members.size(), copies, rank)) {
+                        subset.push_back(members[position]);
+                    }
+                    choices.back().push_back(subset);
+                }
+            }
+            addExpansions(classTeam, choices, 0, topN, TeamIndices{}, namedTeams, topN);
         }
-        return result;
     }
 } // namespace
 
 vector<ScoredTeam> TeamGenerator::generateTopTeams(size_t teamSize, size_t topN, const PokemonList& pinnedMembers) {
     Logger::info("Starting team generation");
+    if (!options_.ranking.valid()) {
+        Logger::error("Ranking weights must be finite and non-negative.");
+        return {};
+    }
+    if (options_.strategy == SearchStrategy::Heuristic) {
+        const HeuristicOptions& heuristic = options_.heuristic;
+        if (heuristic.beamWidth == 0 || (heuristic.evaluationBudget == 0 && heuristic.timeBudget.count() <= 0)) {
+            Logger::error("Heuristic search needs a beam width and an evaluation or time budget.");
+            return {};
+        }
+    }
+    if (topN == 0) return {};
+    heuristicStats_ = HeuristicStats{};
+    return search(teamSize, topN, pinnedMembers, TopTeams(topN));
+}
+
+vector<ScoredTeam> TeamGenerator::generateParetoFrontier(size_t teamSize, const PokemonList& pinnedMembers) {
+    Logger::info("Starting Pareto frontier generation");
+    if (options_.strategy == SearchStrategy::Heuristic) {
+        Logger::error("The Pareto frontier needs an exhaustive or branch-and-bound search.");
+        return {};
+    }
+    // Each point of the frontier keeps one team
+    return search(teamSize, 1, pinnedMembers, ParetoFrontier());
+}
+
+template <typename Collector>
+vector<ScoredTeam> TeamGenerator::search(size_t teamSize, size_t topN, const PokemonList& pinnedMembers, Collector heap) {
+    constexpr bool frontier = std::is_same_v<Collector, ParetoFrontier>;
+    stoppedEarly_ = false;
     if (teamSize < pinnedMembers.size()) {
         Logger::error("Number of pinned members exceeds team size.");
         return {};
@@ -186,6 +1300,14 @@ vector<ScoredTeam> TeamGenerator::generateTopTeams(size_t teamSize, size_t topN,
         Logger::error("Requested team size exceeds available members.");
         return {};
     }
+    if (teamSize > kMaxTeamSize) {
+        Logger::error("Requested team size exceeds the maximum of " + to_string(kMaxTeamSize) + ".");
+        return {};
+    }
+    if (potentialMembers_.size() + pinnedMembers.size() > UINT16_MAX) {
+        Logger::error("Member pool is too large to index.");
+        return {};
+    }
 
     // Remove pinned members from pool to avoid duplicates
     PokemonList availableMembers;
@@ -207,37 +1329,214 @@ vector<ScoredTeam> TeamGenerator::generateTopTeams(size_t teamSize, size_t topN,
     });
 
     size_t slotsToFill = teamSize - pinnedMembers.size();
-    size_t totalTeams = binomial_coefficient(sortedMembers.size(), slotsToFill);
-    size_t completedTeams = 0;
 
-    TypeAbilityComboList targets = loadTypeAbilityCombos("data/type_ability_combos.json");
+    // Targets are the evaluator's, loaded once by the caller and shared by every query
+    const TypeAbilityComboList& targets = evaluator_.targets();
+    if (targets.empty()) Logger::warning("Evaluator has no targets; every offensive score will be 0");
 
-    MinHeap heap;
-    processCombinationsAndUpdateHeap(
-        sortedMembers, 
+    // Pinned members first, then the sorted pool. Candidates are index arrays into this roster
+    // and only the final top-N are materialized back into Pokemon.
+    PokemonList roster = pinnedMembers;
+    roster.insert(roster.end(), sortedMembers.begin(), sortedMembers.end());
+
+    // Precompute each member's coverage and defensive profile once;
+    // teams then only OR bitsets, sum penalties and min-reduce resistances
+    MemberProfileTable rosterProfiles = evaluator_.buildProfiles(roster);
+    // Pinned members are on every candidate, so their coverage, defense and conflict counters
+    // are folded once into the state every candidate starts from
+    CoverageSet pinnedCoverage(targets.size());
+    TeamDefense pinnedDefense;
+    ConflictState pinnedConflicts;
+    for (size_t i = 0; i < pinnedMembers.size(); ++i) {
+        pinnedCoverage.merge(rosterProfiles[i].coverage);
+        pinnedDefense.add(rosterProfiles[i].defense);
+        pinnedConflicts.add(roster[i]);
+    }
+    // Conflicts only grow as members are added
+    const ConflictLimits conflictLimits(conflictRule_);
+    if (pinnedConflicts.conflicts(conflictLimits)) {
+        Logger::info("Pinned members break the conflict rule; no team can be built");
+        return {};
+    }
+
+    dominatedMembersRemoved_ = 0;
+    prunedTeams_ = 0;
+    if (options_.pruneDominatedMembers) {
+        const vector<bool> dominated = findDominatedMembers(
+            roster, rosterProfiles, pinnedMembers.size(), slotsToFill, topN, conflictRule_);
+        PokemonList keptRoster;
+        MemberProfileTable keptProfiles;
+        for (size_t i = 0; i < roster.size(); ++i) {
+            if (dominated[i]) continue;
+            keptRoster.push_back(roster[i]);
+            keptProfiles.push_back(rosterProfiles[i]);
+        }
+        dominatedMembersRemoved_ = roster.size() - keptRoster.size();
+        roster = std::move(keptRoster);
+        rosterProfiles = std::move(keptProfiles);
+        Logger::info("Removed " + to_string(dominatedMembersRemoved_) + " dominated pool members");
+    }
+    const size_t poolSize = roster.size() - pinnedMembers.size();
+
+    const MemberClasses classes = buildMemberClasses(roster, rosterProfiles, pinnedMembers.size(), options_.collapseEquivalentMembers);
+    vector<ConflictState> memberConflicts(classes.representatives.size());
+    for (size_t i = 0; i < memberConflicts.size(); ++i) {
+        memberConflicts[i].add(classes.representatives[i]);
+    }
+    // The non-ghost and mega limits are budgets of the counter, so only teams within them are
+    // enumerated and counted toward progress. A class's members share their types, so a team
+    // without type overlap holds at most one of them.
+    vector<size_t> capacities(classes.representatives.size(), 0);
+    vector<MultisetCounter::Resources> costs;
+    for (size_t c = 0; c < capacities.size(); ++c) {
+        if (c >= pinnedMembers.size()) {
+            capacities[c] = std::min(classes.members[c].size(), conflictLimits.forbidTypeOverlap ? size_t{1} : slotsToFill);
+        }
+        costs.push_back(conflictCost(conflictLimits, memberConflicts[c]));
+    }
+    const MultisetCounter members(std::move(capacities), slotsToFill, std::move(costs), conflictBudget(conflictLimits, pinnedConflicts));
+    size_t totalTeams = members.count(0, slotsToFill);
+    if (options_.collapseEquivalentMembers) {
+        Logger::info("Collapsed " + to_string(poolSize) + " pool members into " +
+            to_string(classes.representatives.size() - pinnedMembers.size()) + " classes; " +
+            to_string(totalTeams) + " of " + to_string(binomialCoefficient(poolSize, slotsToFill)) + " teams to search");
+    }
+
+    // The frontier is searched on offense alone: see BranchAndBoundSearch
+    const RankingPolicy ranking = frontier ? OffenseRanking::policy : options_.ranking;
+    const bool branchAndBound = (options_.strategy == SearchStrategy::BranchAndBound);
+    const bool heuristic = (options_.strategy == SearchStrategy::Heuristic);
+    std::unique_ptr<ScoreBounds> bounds;
+    if (branchAndBound || heuristic) bounds = std::make_unique<ScoreBounds>(classes.profiles, ranking);
+    BranchAndBoundShared shared;
+    const BatchEvaluator batch(classes.profiles);
+    // Class teams to the named teams they stand for, materialized: for snapshots and the result
+    auto nameTeams = [&classes, &roster, topN](const TopTeams& classTeams) {
+        TopTeams namedTeams(topN);
+        expandClassTeams(classes, classTeams, namedTeams, topN);
+        vector<ScoredTeam> teams = namedTeams.results();
+        for (auto& team : teams) team.team = materializeTeam(roster, team.members);
+        return teams;
+    };
+    SearchMonitor monitor(options_, topN, nameTeams);
+
+    const SearchContext ctx{
+        classes.representatives,
+        classes.profiles,
+        classes,
+        members,
+        pinnedMembers.size(),
+        pinnedCoverage,
+        pinnedDefense,
+        pinnedConflicts,
+        memberConflicts,
         slotsToFill, 
         topN, 
         evaluator_, 
-        targets, 
-        heap, 
-        completedTeams, 
-        totalTeams,
-        pinnedMembers,
-        conflictRule_
-    );
-
-    auto allResults = collectResultsFromHeap(heap, topN);
+        batch,
+        conflictLimits,
+        ranking,
+        options_.strategy,
+        bounds.get(),
+        &shared,
+        &monitor
+    };
+
+    size_t threadCount = options_.threadCount;
+    if (threadCount == 0) threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    threadCount = std::max<size_t>(1, std::min(threadCount, totalTeams));
+
+    ProgressCounter progress(totalTeams);
+    if (branchAndBound && !frontier) {
+        shared.raiseThreshold(greedyThreshold(ctx));
+    }
+
+    if (heuristic) {
+        // generateParetoFrontier rejects the heuristic, which ranks teams by one score
+        if constexpr (!frontier) {
+            Logger::info("Searching heuristically with " + to_string(threadCount) + " annealing threads");
+            heuristicStats_ = runHeuristic(ctx, options_.heuristic, threadCount, heap);
+            Logger::info("Heuristic search spent " + to_string(heuristicStats_.evaluations) + " evaluations; best score " +
+                to_string(heuristicStats_.bestScore) + ", upper bound " + to_string(heuristicStats_.upperBound) +
+                " (gap " + to_string(heuristicStats_.gap()) + ")");
+        }
+    } else if (branchAndBound || options_.backend == ExecutionBackend::WorkStealing) {
+        Logger::info("Searching with " + to_string(threadCount) + " work-stealing threads" +
+            (branchAndBound ? " (branch and bound)" : ""));
+        schedulerStats_ = processCombinationsWorkStealing(ctx, threadCount, options_.splitDepth, heap, progress);
+        Logger::info("Scheduler: " + to_string(schedulerStats_.totalTasks()) + " tasks, " +
+            to_string(schedulerStats_.totalSteals()) + " steals, " +
+            to_string(schedulerStats_.totalIdleSeconds()) + "s idle");
+    } else if (threadCount == 1) {
+        processCombinationsAndUpdateHeap(ctx, 0, totalTeams, heap, progress);
+    } else {
+        Logger::info("Searching with " + to_string(threadCount) + " threads");
+        processCombinationsInParallel(ctx, totalTeams, threadCount, heap, progress);
+    }
+
+    if (branchAndBound) {
+        prunedTeams_ = shared.prunedTeams();
+        Logger::info("Branch and bound pruned " + to_string(prunedTeams_) + " / " + to_string(totalTeams) + " teams");
+    }
+
+    stoppedEarly_ = monitor.stopped();
+    if (stoppedEarly_) Logger::warning("Search stopped early; returning the best teams found so far");
+
+    vector<ScoredTeam> allResults;
+    if constexpr (frontier) {
+        // Class teams already carry the named team that wins the tie-breaker of their point
+        allResults = heap.results();
+        for (auto& result : allResults) {
+            result.team = materializeTeam(roster, result.members);
+        }
+    } else {
+        allResults = nameTeams(heap);
+    }
     Logger::info("Team generation complete. Results: " + to_string(allResults.size()));
     return allResults;
 }
 
 vector<ScoredTeam> TeamGenerator::scoreAndFilterTeams(const vector<Team>& teams, const TypeAbilityComboList& targets) {
+    // Profile every distinct member once and score the teams as index tuples in one batch.
+    // Teams that don't fit a TeamIndices take the scalar evaluators.
+    PokemonList members;
+    std::unordered_map<std::string_view, vector<size_t>> membersByName;
+    auto memberIndex = [&](const Pokemon& member) {
+        auto& sameName = membersByName[member.name];
+        for (const size_t index : sameName) {
+            const Pokemon& known = members[index];
+            if (known.primaryType == member.primaryType && known.secondaryType == member.secondaryType &&
+                known.abilities == member.abilities) return index;
+        }
+        sameName.push_back(members.size());
+        members.push_back(member);
+        return members.size() - 1;
+    };
+
+    vector<TeamIndices> indexed(teams.size());
+    vector<bool> batched(teams.size(), false);
+    for (size_t i = 0; i < teams.size(); ++i) {
+        if (teams[i].size() > kMaxTeamSize) continue;
+        for (const auto& member : teams[i]) {
+            const size_t index = memberIndex(member);
+            if (index > std::numeric_limits<uint16_t>::max()) break;
+            indexed[i].push_back(index);
+        }
+        batched[i] = (indexed[i].size() == teams[i].size());
+    }
+
+    const MemberProfileTable profiles = evaluator_.buildProfiles(members, targets);
+    const BatchEvaluator batch(profiles);
+    vector<BatchScore> scores(teams.size());
+    batch.score(indexed.data(), indexed.size(), scores.data());
+
     vector<ScoredTeam> scored;
-    for (const auto& team : teams) {
-        double offenseScore = evaluator_.evaluateOffense(team, targets);
-        double defenseScore = evaluator_.evaluateDefense(team, TypeUtils::all());
-        if (defenseScore >= 0.0) {
-            scored.push_back(ScoredTeam{team, offenseScore, defenseScore});
+    for (size_t i = 0; i < teams.size(); ++i) {
+        if (!batched[i]) {
+            scores[i] = BatchScore{evaluator_.evaluateOffense(teams[i], targets), evaluator_.evaluateDefense(teams[i], TypeUtils::all())};
+        }
+        if (scores[i].defense >= 0.0) {
+            scored.push_back(ScoredTeam{teams[i], scores[i].offense, scores[i].defense, {}});
         }
     }
     return scored;
@@ -1,13 +1,105 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include "pokemon.h"
+#include "ranking.h"
+#include "scheduler.h"
 #include "team.h"
 
-// Enum for team conflict rules
+// Team conflict rules. Each rule is a bit, so rules compose with |
+// (ConflictRule::TGOM_Ghost | ConflictRule::NoTypeOverlap). At most one mega is always enforced.
 enum class ConflictRule : uint8_t {
-    NoRule, NoTypeOverlap, TGOM_Ghost
+    NoRule = 0,
+    NoTypeOverlap = 1 << 0, // no type shared by two members
+    TGOM_Ghost = 1 << 1     // at most two non-ghost members
+};
+
+constexpr ConflictRule operator|(ConflictRule a, ConflictRule b) {
+    return static_cast<ConflictRule>(static_cast<uint8_t>(a) | static_cast<uint8_t>(b));
+}
+
+// True when `rules` includes every rule in `rule`
+constexpr bool hasRule(ConflictRule rules, ConflictRule rule) {
+    return (static_cast<uint8_t>(rules) & static_cast<uint8_t>(rule)) == static_cast<uint8_t>(rule);
+}
+
+// How the combination search is spread over threads
+enum class ExecutionBackend : uint8_t {
+    StaticRanges,   // one contiguous rank range per thread (serial when threadCount is 1)
+    WorkStealing    // prefix tasks on per-worker deques; idle workers steal
+};
+
+// How the candidate space is searched
+enum class SearchStrategy : uint8_t {
+    Exhaustive,     // score every combination
+    BranchAndBound, // skip prefixes whose optimistic score bound can't reach the current top-N
+    Heuristic       // beam search, then simulated annealing, within a budget: the best teams found, not proven best
+};
+
+// SearchStrategy::Heuristic: a beam search builds teams one slot at a time, keeping the
+// beamWidth best partial teams, then every worker thread anneals single-member swaps from the
+// beam's teams. The search stops at whichever budget runs out first; 0 leaves a budget unlimited,
+// but one of them must be set. An evaluation budget alone makes runs repeatable.
+struct HeuristicOptions {
+    size_t beamWidth = 64;
+    size_t evaluationBudget = 1000000; // beam teams scored plus annealing swaps proposed
+    std::chrono::milliseconds timeBudget{0};
+    uint64_t seed = 1;
+};
+
+// Outcome of the last Heuristic run. No team scores above upperBound under the ranking, so the
+// gap bounds how far the best team found can be from the best team there is.
+struct HeuristicStats {
+    size_t evaluations = 0;
+    double bestScore = -std::numeric_limits<double>::infinity(); // combined score of the best team found
+    double upperBound = std::numeric_limits<double>::infinity();
+
+    double gap() const { return upperBound - bestScore; }
+};
+
+// Lets any thread stop a running search early: see GeneratorOptions::cancellation
+class CancellationToken {
+public:
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled_{false};
+};
+
+// Tuning knobs for generateTopTeams. Defaults reproduce the plain serial search.
+struct GeneratorOptions {
+    SearchStrategy strategy = SearchStrategy::Exhaustive;
+    // Worker threads for the combination search. 0 uses every hardware thread.
+    // BranchAndBound always runs on the work-stealing backend; Heuristic anneals on every thread.
+    size_t threadCount = 1;
+    ExecutionBackend backend = ExecutionBackend::StaticRanges;
+    // WorkStealing: prefixes shorter than this many chosen members are split into child tasks
+    size_t splitDepth = 2;
+    // Search over classes of pool members with the same types, abilities' effects and mega status
+    // instead of over named members. Reports the same teams; only progress counts change.
+    bool collapseEquivalentMembers = false;
+    // Drop pool members that enough other members beat or match on coverage, on every attacking
+    // type and on conflicts. The top-N scores are unchanged; among teams tied with them, others may be reported.
+    bool pruneDominatedMembers = false;
+    // How offense and defense combine into the score teams are ranked by. Weights must be non-negative.
+    RankingPolicy ranking;
+    HeuristicOptions heuristic;
+    // End the search early once the token is cancelled or the deadline passes, returning the best
+    // teams found so far. Workers check every few thousand teams. The token must outlive the search.
+    const CancellationToken* cancellation = nullptr;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // Called with the current top-N (materialized, best first) at most once per snapshotInterval
+    // while generateTopTeams runs. Runs on a search thread and calls never overlap; each worker's
+    // teams are as of its last check, at most about one interval old.
+    std::function<void(const std::vector<ScoredTeam>&)> onSnapshot;
+    std::chrono::milliseconds snapshotInterval{1000};
 };
 
 class TeamGenerator {
@@ -15,22 +107,50 @@ public:
     TeamGenerator(
         const PokemonList& potentialMembers, 
         const TeamEvaluator& evaluator, 
-        ConflictRule conflictRule
+        ConflictRule conflictRule,
+        const GeneratorOptions& options = {}
     ): 
         potentialMembers_(potentialMembers), 
         evaluator_(evaluator),
-        conflictRule_(conflictRule) {}
+        conflictRule_(conflictRule),
+        options_(options) {}
 
     std::vector<ScoredTeam> generateTopTeams(
         size_t teamSize, 
         size_t topN = 10,
         const PokemonList& pinnedMembers = {}
     );
+    // The Pareto frontier of (offensiveScore, defensiveScore) over the teams generateTopTeams
+    // searches, found in one pass, by descending offense. Ignores options.ranking: rankFrontier
+    // (ranking.h) answers any weighting from the result without another search.
+    std::vector<ScoredTeam> generateParetoFrontier(size_t teamSize, const PokemonList& pinnedMembers = {});
     std::vector<ScoredTeam> scoreAndFilterTeams(const std::vector<Team>& teams, const TypeAbilityComboList& targets);
     static void reportProgress(size_t completed, size_t total);
 
+    // Statistics of the last WorkStealing run
+    const SchedulerStats& schedulerStats() const { return schedulerStats_; }
+    // Pool members the last run dropped as dominated
+    size_t dominatedMembersRemoved() const { return dominatedMembersRemoved_; }
+    // Teams the last BranchAndBound run skipped without scoring them
+    size_t prunedTeams() const { return prunedTeams_; }
+    // Budget spent and bound gap of the last Heuristic run
+    const HeuristicStats& heuristicStats() const { return heuristicStats_; }
+    // Whether the last run ended at its cancellation or deadline, with the best teams found until then
+    bool stoppedEarly() const { return stoppedEarly_; }
+
 private:
+    // The search both generators share, collecting into `heap` (TopTeams or ParetoFrontier).
+    // topN bounds how many teams a score may stand for, e.g. in dominance pruning.
+    template <typename Collector>
+    std::vector<ScoredTeam> search(size_t teamSize, size_t topN, const PokemonList& pinnedMembers, Collector heap);
+
     const PokemonList& potentialMembers_;
     const TeamEvaluator& evaluator_;
     const ConflictRule conflictRule_;
+    const GeneratorOptions options_;
+    SchedulerStats schedulerStats_;
+    size_t dominatedMembersRemoved_ = 0;
+    size_t prunedTeams_ = 0;
+    HeuristicStats heuristicStats_;
+    bool stoppedEarly_ = false;
 };
@@ -0,0 +1,62 @@
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "intern.h"
+
+StringPool::Id StringPool::intern(std::string_view text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = ids_.find(text);
+    if (it != ids_.end()) return it->second;
+
+    if (views_.size() >= std::numeric_limits<Id>::max()) {
+        throw std::runtime_error("Too many distinct strings to intern: " + std::string(text));
+    }
+    const Id id = static_cast<Id>(views_.size());
+    const std::string_view stored = store(text);
+    views_.push_back(stored);
+    ids_.emplace(stored, id);
+    return id;
+}
+
+std::string_view StringPool::view(Id id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return id < views_.size() ? views_[id] : std::string_view();
+}
+
+size_t StringPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return views_.size();
+}
+
+size_t StringPool::arenaBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return arenaBytes_;
+}
+
+std::string_view StringPool::store(std::string_view text) {
+    if (text.empty()) return std::string_view();
+    if (text.size() > kBlockSize) {
+        // Too long to share a block: it gets one of its own and the current block stays in use
+        blocks_.push_back(std::make_unique<char[]>(text.size()));
+        arenaBytes_ += text.size();
+        std::memcpy(blocks_.back().get(), text.data(), text.size());
+        return std::string_view(blocks_.back().get(), text.size());
+    }
+    if (text.size() > freeBytes_) {
+        blocks_.push_back(std::make_unique<char[]>(kBlockSize));
+        arenaBytes_ += kBlockSize;
+        free_ = blocks_.back().get();
+        freeBytes_ = kBlockSize;
+    }
+    char* start = free_;
+    std::memcpy(start, text.data(), text.size());
+    free_ += text.size();
+    freeBytes_ -= text.size();
+    return std::string_view(start, text.size());
+}
+
+std::string_view internName(std::string_view name) {
+    static StringPool names;
+    return names.view(names.intern(name));
+}
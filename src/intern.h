@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Append-only arena of distinct strings. Each string's characters are copied once into blocks
+// that never move or shrink, so the ID and string_view it is given stay valid for the pool's
+// lifetime and can be copied around without allocating. Safe to use from several threads.
+class StringPool {
+public:
+    using Id = uint32_t;
+
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // ID of a string, storing it the first time it's seen. IDs count up from 0.
+    Id intern(std::string_view text);
+    // The pool's copy of an interned string, or an empty view for an unknown ID
+    std::string_view view(Id id) const;
+    // Distinct strings held
+    size_t size() const;
+    // Bytes allocated for string storage
+    size_t arenaBytes() const;
+
+private:
+    static constexpr size_t kBlockSize = 4096;
+
+    // Copies text into the arena; the caller holds mutex_
+    std::string_view store(std::string_view text);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t arenaBytes_ = 0;
+    char* free_ = nullptr;  // unused tail of the newest block
+    size_t freeBytes_ = 0;
+    std::unordered_map<std::string_view, Id> ids_; // keys view the arena
+    std::vector<std::string_view> views_;          // [id]
+};
+
+// Process-wide pool of Pokemon names. The views it returns stay valid until exit.
+std::string_view internName(std::string_view name);
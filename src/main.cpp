@@ -1,20 +1,48 @@
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include "abilities.h"
 #include "generator.h"
 #include "types.h"
 #include "pokemon.h"
 #include "logger.h"
+#include "snapshot.h"
 
-namespace { // file-local aliases
+namespace { // file-local aliases and helpers
     using std::cout;
+
+    // A snapshot written by team_snapshot from the JSON files is mapped instead of parsing them,
+    // as long as the files are still the ones it was built from
+    GameData loadData() {
+        const string snapshotPath = "data/teamMembers_tgom_ghost.snapshot";
+        const string pokemonPath = "data/teamMembers_tgom_ghost.json";
+        const string typeChartPath = "data/typeChart.json";
+        const string abilityEffectsPath = "data/abilityEffects.json";
+        const string targetsPath = "data/type_ability_combos.json";
+        if (std::ifstream(snapshotPath).is_open()) {
+            try {
+                if (snapshotSources(snapshotPath) == fingerprintSources(pokemonPath, typeChartPath, abilityEffectsPath, targetsPath)) {
+                    return loadSnapshot(snapshotPath);
+                }
+                Logger::warning("Snapshot " + snapshotPath + " is out of date with the JSON data files; loading the JSON instead");
+            } catch (const std::runtime_error& ex) {
+                Logger::warning(string(ex.what()) + "; loading the JSON data files instead");
+            }
+        }
+        return loadGameData(pokemonPath, typeChartPath, abilityEffectsPath, targetsPath);
+    }
 }
 
 int main() {
     Logger::setLogLevel(LogLevel::Info);
 
-    TypeEffectiveness typeChart = loadTypeEffectiveness("data/typeChart.json");
-    PokemonList coolPokemon = loadPokemon("data/teamMembers_tgom_ghost.json");
-    TeamEvaluator evaluator(typeChart);
-    TeamGenerator generator(coolPokemon, evaluator, ConflictRule::TGOM_Ghost);
+    const GameData data = loadData();
+    TeamEvaluator evaluator(data.typeChart, data.abilityEffects, data.targets, data.targetCoverage);
+    GeneratorOptions options;
+    options.threadCount = 0; // every hardware thread
+    options.collapseEquivalentMembers = true;
+    options.pruneDominatedMembers = true;
+    TeamGenerator generator(data.pokemon, evaluator, ConflictRule::TGOM_Ghost, options);
 
     vector<ScoredTeam> topTeams = generator.generateTopTeams(
         6, 
@@ -44,7 +72,7 @@ int main() {
             }
             cout << ") Abilities: ";
             for (size_t j = 0; j < member.abilities.size(); ++j) {
-                cout << member.abilities[j];
+                cout << abilityName(member.abilities[j]);
                 if (j + 1 < member.abilities.size()) cout << ", ";
             }
             cout << "\n";
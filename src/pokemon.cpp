@@ -1,12 +1,211 @@
 #include <nlohmann/json.hpp>
 #include <fstream>
+#include <iterator>
 #include <stdexcept>
+#include "abilities.h"
+#include "intern.h"
 #include "pokemon.h"
 #include "logger.h"
 
-namespace { // file-local aliases
+namespace { // file-local aliases and SAX loading
     using std::runtime_error;
     using json = nlohmann::json;
+
+    // Input iterator over a stream buffer that counts the lines consumed, so records can be
+    // reported by position while the file is streamed
+    class LineCountingIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = char;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char*;
+        using reference = char;
+
+        LineCountingIterator() = default; // end of stream
+        LineCountingIterator(std::istream& in, size_t& line) : it_(in), line_(&line) {}
+
+        char operator*() const { return *it_; }
+        LineCountingIterator& operator++() {
+            if (*it_ == '\n') ++*line_;
+            ++it_;
+            return *this;
+        }
+        LineCountingIterator operator++(int) {
+            LineCountingIterator before = *this;
+            ++*this;
+            return before;
+        }
+        bool operator==(const LineCountingIterator& other) const { return it_ == other.it_; }
+        bool operator!=(const LineCountingIterator& other) const { return !(*this == other); }
+
+    private:
+        std::istreambuf_iterator<char> it_;
+        size_t* line_ = nullptr;
+    };
+
+    // Builds Pokemon straight from SAX events, without a DOM: a top-level array of records, each
+    // an object with "name", "primaryType", an optional "secondaryType" and "abilities". Other
+    // keys are skipped whatever their value. Names and abilities are interned as they arrive.
+    // Every violation throws with the record and line.
+    class PokemonSaxHandler : public nlohmann::json_sax<json> {
+    public:
+        PokemonSaxHandler(const std::string& path, const size_t& line, PokemonList& pokemon)
+            : path_(path), line_(line), pokemon_(pokemon) {}
+
+        bool null() override {
+            if (skipping() || inAbilities()) return fieldValue("null");
+            if (field_ == Field::SecondaryType) {
+                current_.secondaryType = std::nullopt;
+                return true;
+            }
+            return fieldValue("null");
+        }
+        bool boolean(bool) override { return fieldValue("a boolean"); }
+        bool number_integer(number_integer_t) override { return fieldValue("a number"); }
+        bool number_unsigned(number_unsigned_t) override { return fieldValue("a number"); }
+        bool number_float(number_float_t, const string_t&) override { return fieldValue("a number"); }
+        bool binary(binary_t&) override { return fieldValue("binary data"); }
+
+        bool string(string_t& value) override {
+            if (skipping()) return true;
+            if (inAbilities()) {
+                if (current_.abilities.full()) invalid("more than " + std::to_string(kMaxAbilities) + " abilities");
+                current_.abilities.push_back(internAbility(value));
+                return true;
+            }
+            if (depth_ != kRecordDepth) return fieldValue("a string");
+            try {
+                switch (field_) {
+                case Field::Name: current_.name = internName(value); seen_ |= kHasName; break;
+                case Field::PrimaryType: current_.primaryType = stringToType(value); seen_ |= kHasPrimaryType; break;
+                case Field::SecondaryType: current_.secondaryType = stringToType(value); break;
+                case Field::Abilities: invalid("\"abilities\" must be an array of strings"); break;
+                case Field::Other: break;
+                }
+            } catch (const std::invalid_argument& ex) {
+                invalid(ex.what());
+            }
+            return true;
+        }
+
+        bool start_object(std::size_t) override {
+            if (!skipping()) {
+                if (depth_ == 0) invalid("expected an array of Pokemon records");
+                if (depth_ == kRecordDepth - 1) {
+                    current_ = Pokemon{};
+                    seen_ = 0;
+                    recordLine_ = line_;
+                } else if (depth_ == kRecordDepth && field_ == Field::Other) {
+                    skipFrom_ = depth_;
+                } else {
+                    fieldValue("an object");
+                }
+            }
+            ++depth_;
+            return true;
+        }
+
+        bool key(string_t& name) override {
+            if (skipping() || depth_ != kRecordDepth) return true;
+            if (name == "name") field_ = Field::Name;
+            else if (name == "primaryType") field_ = Field::PrimaryType;
+            else if (name == "secondaryType") field_ = Field::SecondaryType;
+            else if (name == "abilities") field_ = Field::Abilities;
+            else field_ = Field::Other;
+            return true;
+        }
+
+        bool end_object() override {
+            --depth_;
+            if (endSkip()) return true;
+            if (depth_ == kRecordDepth - 1) {
+                if (!(seen_ & kHasName)) invalidRecord("missing \"name\"");
+                if (!(seen_ & kHasPrimaryType)) invalidRecord("missing \"primaryType\"");
+                if (!(seen_ & kHasAbilities)) invalidRecord("missing \"abilities\"");
+                pokemon_.push_back(std::move(current_));
+                ++record_;
+            }
+            return true;
+        }
+
+        bool start_array(std::size_t) override {
+            if (!skipping()) {
+                if (depth_ == kRecordDepth && field_ == Field::Abilities) {
+                    current_.abilities = AbilityList();
+                    seen_ |= kHasAbilities;
+                } else if (depth_ == kRecordDepth && field_ == Field::Other) {
+                    skipFrom_ = depth_;
+                } else if (depth_ != 0) {
+                    fieldValue("an array");
+                }
+            }
+            ++depth_;
+            return true;
+        }
+
+        bool end_array() override {
+            --depth_;
+            endSkip();
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+            throw runtime_error("JSON parse error: " + std::string(ex.what()));
+        }
+
+    private:
+        enum class Field { Name, PrimaryType, SecondaryType, Abilities, Other };
+        static constexpr size_t kRecordDepth = 2; // inside a record object
+        static constexpr unsigned kHasName = 1, kHasPrimaryType = 2, kHasAbilities = 4;
+        static constexpr size_t kNotSkipping = SIZE_MAX;
+
+        bool skipping() const { return skipFrom_ != kNotSkipping; }
+        bool inAbilities() const { return depth_ == kRecordDepth + 1 && field_ == Field::Abilities; }
+        // Leaves a skipped container once its end brings the depth back to where it started
+        bool endSkip() {
+            if (!skipping()) return false;
+            if (depth_ == skipFrom_) skipFrom_ = kNotSkipping;
+            return true;
+        }
+
+        // A scalar that isn't a string: fine under a skipped key, an error anywhere else
+        bool fieldValue(const char* kind) {
+            if (skipping() || (depth_ == kRecordDepth && field_ == Field::Other)) return true;
+            if (depth_ == 0) invalid("expected an array of Pokemon records");
+            if (depth_ == kRecordDepth - 1) invalid(std::string("expected a record object, found ") + kind);
+            if (inAbilities()) invalid(std::string("\"abilities\" must hold strings, found ") + kind);
+            invalid("\"" + fieldName() + "\" can't be " + kind);
+            return false;
+        }
+
+        std::string fieldName() const {
+            switch (field_) {
+            case Field::Name: return "name";
+            case Field::PrimaryType: return "primaryType";
+            case Field::SecondaryType: return "secondaryType";
+            case Field::Abilities: return "abilities";
+            default: return "?";
+            }
+        }
+
+        [[noreturn]] void invalidAt(size_t line, const std::string& problem) const {
+            throw runtime_error("Invalid Pokemon data format in " + path_ + " at line " + std::to_string(line) +
+                " (record " + std::to_string(record_ + 1) + "): " + problem);
+        }
+        [[noreturn]] void invalid(const std::string& problem) const { invalidAt(line_, problem); }
+        [[noreturn]] void invalidRecord(const std::string& problem) const { invalidAt(recordLine_, problem); }
+
+        const std::string& path_;
+        const size_t& line_;
+        PokemonList& pokemon_;
+        Pokemon current_;
+        Field field_ = Field::Other;
+        unsigned seen_ = 0;
+        size_t depth_ = 0;
+        size_t skipFrom_ = kNotSkipping;
+        size_t record_ = 0;
+        size_t recordLine_ = 1;
+    };
 }
 
 /*
@@ -27,43 +226,15 @@ PokemonList loadPokemon(const string& path) {
     Logger::info("Loading Pokemon data from: " + path);
     PokemonList pokemonList;
 
-    std::ifstream file(path);
+    std::ifstream file(path, std::ios::binary);
     if (!file.is_open()) {
-        // Logger::error("Could not open Pokemon data file: " + path);
         throw runtime_error("Could not open Pokemon data file: " + path);
     }
 
-    json j;
-    try {
-        file >> j;
-    } catch (const json::parse_error& e) {
-        // Logger::error("JSON parse error: " + string(e.what()));
-        throw runtime_error("JSON parse error: " + string(e.what()));
-    }
-
-    for (const auto& item : j) {
-        // Validate required fields
-        if (!item.contains("name") || !item.contains("primaryType") || !item.contains("abilities")) {
-            // Logger::error("Invalid Pokemon data format");
-            throw runtime_error("Invalid Pokemon data format");
-        }
-
-        Pokemon pokemon;
-        pokemon.name = item.at("name").get<string>();
-        pokemon.primaryType = stringToType(item.at("primaryType").get<string>());
-
-        // optional secondary type
-        if (item.contains("secondaryType") && !item.at("secondaryType").is_null()) {
-            pokemon.secondaryType = stringToType(item.at("secondaryType").get<string>());
-        }
-        else {
-            pokemon.secondaryType = std::nullopt; // single-typed
-        }
-
-        pokemon.abilities = item.at("abilities").get<vector<string>>();
-
-        pokemonList.push_back(pokemon);
-    }
+    // Streamed through SAX events, so no DOM of the whole file is built
+    size_t line = 1;
+    PokemonSaxHandler handler(path, line, pokemonList);
+    json::sax_parse(LineCountingIterator(file, line), LineCountingIterator(), &handler);
 
     Logger::info("Loaded " + std::to_string(pokemonList.size()) + " Pokemon from file.");
     return pokemonList;
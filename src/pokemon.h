@@ -2,18 +2,23 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include "types.h"
 
 using std::string;
 using std::vector;
 
+// Names and abilities are interned (see intern.h and abilities.h), so a Pokemon is a handful of
+// bytes that copy without allocating, however many teams and heap entries hold it
 struct Pokemon {
-    string name;
+    std::string_view name; // interned with internName, or a string literal
     Type primaryType;
     std::optional<Type> secondaryType;
-    vector<string> abilities;
+    AbilityList abilities;
 };
+static_assert(std::is_trivially_copyable<Pokemon>::value, "Pokemon is copied freely by the generator");
 
 using PokemonList = std::vector<Pokemon>;
 
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "profile.h"
+
+void CoverageSet::merge(const CoverageSet& other) {
+    for (size_t w = 0; w < words_.size(); ++w) {
+        words_[w] |= other.words_[w];
+    }
+}
+
+void CoverageSet::clear() {
+    for (auto& word : words_) word = 0;
+}
+
+size_t CoverageSet::count() const {
+    size_t total = 0;
+    for (const auto word : words_) {
+        total += std::bitset<64>(word).count();
+    }
+    return total;
+}
+
+size_t CoverageSet::countUnion(const CoverageSet& other) const {
+    size_t total = 0;
+    for (size_t w = 0; w < words_.size(); ++w) {
+        total += std::bitset<64>(words_[w] | other.words_[w]).count();
+    }
+    return total;
+}
+
+size_t CoverageSet::countNotIn(const CoverageSet& other) const {
+    size_t total = 0;
+    for (size_t w = 0; w < words_.size(); ++w) {
+        total += std::bitset<64>(words_[w] & ~other.words_[w]).count();
+    }
+    return total;
+}
+
+FixedEffectiveness encodeEffectiveness(double effectiveness) {
+    const double scaled = effectiveness * kEffectivenessScale;
+    if (!(scaled >= 0.0) || scaled > std::numeric_limits<FixedEffectiveness>::max() || scaled != std::floor(scaled)) {
+        throw std::invalid_argument("Effectiveness multiplier has no exact fixed-point encoding: " + std::to_string(effectiveness));
+    }
+    return static_cast<FixedEffectiveness>(scaled);
+}
+
+double resistBonus(double bestResist) {
+    if (bestResist == 0.0 || bestResist == 0.25) return 2.0;
+    if (bestResist == 0.5) return 1.0;
+    // Neutral (1.0) or other values: no change
+    return 0.0;
+}
+
+bool resistsAtLeastAsWell(FixedEffectiveness candidate, FixedEffectiveness other) {
+    if (candidate > other) return false;
+    // The team keeps its lowest multiplier and resistBonus isn't monotone (0.125 earns less
+    // than 0.25), so no rewarded multiplier a teammate could hold in between may pay more
+    constexpr FixedEffectiveness rewardedMultipliers[] = {0, kEffectivenessScale / 4, kEffectivenessScale / 2};
+    for (FixedEffectiveness rewarded : rewardedMultipliers) {
+        if (candidate <= rewarded && rewarded <= other && resistBonus(rewarded) > resistBonus(candidate)) return false;
+    }
+    return true;
+}
+
+void TeamDefense::reset() {
+    bestResist.fill(std::numeric_limits<FixedEffectiveness>::max()); // no lower than any member's multiplier
+    weakness = 0;
+}
+
+void TeamDefense::add(const DefenseProfile& member) {
+    for (size_t t = 0; t < NUM_TYPES; ++t) {
+        bestResist[t] = std::min(bestResist[t], member.effectiveness[t]);
+    }
+    weakness += member.totalWeakness;
+}
+
+double TeamDefense::score() const {
+    int bonus = 0;
+    for (const auto resist : bestResist) {
+        bonus += resistBonus(resist);
+    }
+    return bonus - decodeEffectiveness(weakness);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "types.h"
+
+// Fixed-length bitset over a target list.
+// Bit i is set when the owner can hit target i super effectively.
+class CoverageSet {
+public:
+    CoverageSet() = default;
+    explicit CoverageSet(size_t size)
+        : words_((size + 63) / 64, 0), size_(size) {}
+    // A set of `size` targets from its packed words() (size / 64 rounded up of them)
+    CoverageSet(size_t size, const uint64_t* words)
+        : words_(words, words + (size + 63) / 64), size_(size) {}
+
+    void set(size_t i) { words_[i / 64] |= (uint64_t{1} << (i % 64)); }
+    bool test(size_t i) const { return (words_[i / 64] >> (i % 64)) & 1u; }
+
+    // OR another set (over the same target list) into this one
+    void merge(const CoverageSet& other);
+    void clear();
+    size_t count() const;
+    // count() of the OR with another set, without building it
+    size_t countUnion(const CoverageSet& other) const;
+    // Number of bits set here but not in another set
+    size_t countNotIn(const CoverageSet& other) const;
+    size_t size() const { return size_; }
+    // Packed bits, target i at bit i % 64 of word i / 64
+    const std::vector<uint64_t>& words() const { return words_; }
+    bool operator==(const CoverageSet& other) const { return words_ == other.words_; }
+
+private:
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+};
+
+// Effectiveness multiplier in fixed point with 1/256 steps (1.0 is 256). Chart values and every
+// ability modifier product (0.125, 0.3125, 0.75 x 2, 1.25 x 4, ...) are exact, so profile and
+// team scoring run on integer lanes and compare exactly instead of testing doubles with ==.
+using FixedEffectiveness = uint16_t;
+constexpr uint32_t kEffectivenessScale = 256;
+
+// Throws std::invalid_argument when the multiplier is negative, too large or not a multiple of 1/256
+FixedEffectiveness encodeEffectiveness(double effectiveness);
+// Exact: every fixed-point sum up to 2^53 steps is a representable double
+constexpr double decodeEffectiveness(uint32_t fixed) { return static_cast<double>(fixed) / kEffectivenessScale; }
+
+// How a single member takes hits from each attacking type (indexed by Type), in fixed point.
+struct DefenseProfile {
+    std::array<FixedEffectiveness, NUM_TYPES> effectiveness{}; // incoming multiplier, abilities applied
+    std::array<FixedEffectiveness, NUM_TYPES> weakness{};      // penalty (eff - 1.0) when eff > 1.0, else 0
+    uint32_t totalWeakness = 0;                                // sum of weakness over all attacking types
+};
+
+// Points awarded for the best (lowest) multiplier a team has against one attacking type.
+// Immunity (0.0) or 0.25 resistance: +2, 0.5 resistance: +1, anything else: 0
+double resistBonus(double bestResist);
+// Same table on a fixed-point multiplier, without branches
+inline int resistBonus(FixedEffectiveness bestResist) {
+    return 2 * ((bestResist == 0) | (bestResist == kEffectivenessScale / 4)) + (bestResist == kEffectivenessScale / 2);
+}
+
+// True when a member taking `candidate` from an attacking type can replace one taking `other`
+// without lowering the team's resist bonus for that type, whatever its teammates take.
+bool resistsAtLeastAsWell(FixedEffectiveness candidate, FixedEffectiveness other);
+
+// Defensive state of a (partial) team against every attacking type.
+// Team defense decomposes into a sum of member penalties plus an 18-lane min-reduction,
+// both on fixed-point integers.
+struct TeamDefense {
+    std::array<FixedEffectiveness, NUM_TYPES> bestResist;
+    uint32_t weakness = 0; // fixed point
+
+    TeamDefense() { reset(); }
+    void reset();
+    void add(const DefenseProfile& member);
+    // Same value as TeamEvaluator::evaluateDefense(team, TypeUtils::all())
+    double score() const;
+};
+
+// Everything about a single member that stays fixed for a given target list.
+// Built once per generation run so team scoring never calls getTypeEffectiveness.
+struct MemberProfile {
+    CoverageSet coverage;
+    DefenseProfile defense;
+};
+
+using MemberProfileTable = std::vector<MemberProfile>;
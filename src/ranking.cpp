@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include "ranking.h"
+
+namespace { // file-local bit packing
+    constexpr uint64_t kSignBit = uint64_t{1} << 63;
+
+    // Unsigned integer that sorts like the double (-0.0 folded into 0.0)
+    uint64_t orderedBits(double value) {
+        value += 0.0;
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & kSignBit) ? ~bits : (bits | kSignBit);
+    }
+
+    double fromOrderedBits(uint64_t bits) {
+        bits = (bits & kSignBit) ? (bits & ~kSignBit) : ~bits;
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Slot i of a team sits at bits [48 - 16 * (i % 4), 64 - 16 * (i % 4)) of word 3 + i / 4
+    constexpr size_t kMemberWord = 3;
+    constexpr size_t kSlotsPerWord = 4;
+
+    size_t slotShift(size_t slot) { return 48 - 16 * (slot % kSlotsPerWord); }
+}
+
+bool RankingPolicy::valid() const {
+    return std::isfinite(offenseWeight) && std::isfinite(defenseWeight) && offenseWeight >= 0.0 && defenseWeight >= 0.0;
+}
+
+RankKey::RankKey(double combinedScore, double offensiveScore, double defensiveScore, const TeamIndices& members) {
+    words_[0] = orderedBits(combinedScore);
+    words_[1] = orderedBits(offensiveScore);
+    words_[2] = orderedBits(defensiveScore);
+    for (size_t slot = 0; slot < members.size(); ++slot) {
+        words_[kMemberWord + slot / kSlotsPerWord] |= uint64_t{members.slots[slot]} << slotShift(slot);
+    }
+    // A team that extends another ranks above it, as with TeamIndices::operator<
+    words_[4] |= members.size();
+}
+
+RankKey RankKey::bestWithCombined(double combinedScore, double offensiveScore, double defensiveScore) {
+    RankKey key(combinedScore, offensiveScore, defensiveScore, TeamIndices{});
+    key.words_[3] = key.words_[4] = ~uint64_t{0};
+    return key;
+}
+
+RankKey RankKey::withMembers(const TeamIndices& members) const {
+    return RankKey(combinedScore(), offensiveScore(), defensiveScore(), members);
+}
+
+double RankKey::combinedScore() const { return fromOrderedBits(words_[0]); }
+double RankKey::offensiveScore() const { return fromOrderedBits(words_[1]); }
+double RankKey::defensiveScore() const { return fromOrderedBits(words_[2]); }
+
+TeamIndices RankKey::members() const {
+    TeamIndices members;
+    const size_t count = words_[4] & 0xFF;
+    for (size_t slot = 0; slot < count; ++slot) {
+        members.push_back((words_[kMemberWord + slot / kSlotsPerWord] >> slotShift(slot)) & 0xFFFF);
+    }
+    return members;
+}
+
+TopTeams::TopTeams(size_t capacity) : capacity_(capacity) {
+    keys_.reserve(std::min(capacity, kReservedEntries));
+}
+
+bool TopTeams::offer(const RankKey& key) {
+    if (!accepts(key)) return false;
+    // std::greater keeps the lowest key at the front
+    if (full()) {
+        std::pop_heap(keys_.begin(), keys_.end(), std::greater<RankKey>());
+        keys_.back() = key;
+    } else {
+        keys_.push_back(key);
+    }
+    std::push_heap(keys_.begin(), keys_.end(), std::greater<RankKey>());
+    return true;
+}
+
+bool TopTeams::contains(const RankKey& key) const {
+    return std::find(keys_.begin(), keys_.end(), key) != keys_.end();
+}
+
+void TopTeams::merge(const TopTeams& other) {
+    for (const auto& key : other.keys_) offer(key);
+}
+
+std::vector<ScoredTeam> TopTeams::results() const {
+    std::vector<RankKey> sorted = keys_;
+    std::sort(sorted.begin(), sorted.end(), std::greater<RankKey>());
+    std::vector<ScoredTeam> teams;
+    teams.reserve(sorted.size());
+    for (const auto& key : sorted) {
+        teams.push_back(ScoredTeam{Team{}, key.offensiveScore(), key.defensiveScore(), key.members()});
+    }
+    return teams;
+}
+
+bool ParetoFrontier::dominated(double offensiveScore, double defensiveScore) const {
+    // The first point with at least this offense has the highest defense of all such points
+    const auto it = points_.lower_bound(offensiveScore);
+    if (it == points_.end()) return false;
+    const double defense = it->second.defensiveScore();
+    return defense > defensiveScore || (defense == defensiveScore && it->first > offensiveScore);
+}
+
+bool ParetoFrontier::offer(const RankKey& key) {
+    const double offense = key.offensiveScore();
+    const double defense = key.defensiveScore();
+    if (dominated(offense, defense)) return false;
+
+    auto it = points_.lower_bound(offense);
+    if (it != points_.end() && it->first == offense && it->second.defensiveScore() == defense) {
+        // Same point: the higher-ranked team keeps it
+        if (!(key > it->second)) return false;
+        it->second = key;
+        return true;
+    }
+    // The points this one dominates sit right before it: no more offense and no more defense
+    if (it != points_.end() && it->first == offense) it = points_.erase(it);
+    auto first = it;
+    while (first != points_.begin() && std::prev(first)->second.defensiveScore() <= defense) --first;
+    points_.erase(first, it);
+    points_.emplace_hint(it, offense, key);
+    return true;
+}
+
+void ParetoFrontier::merge(const ParetoFrontier& other) {
+    for (const auto& [offense, key] : other.points_) offer(key);
+}
+
+std::vector<ScoredTeam> ParetoFrontier::results() const {
+    std::vector<ScoredTeam> teams;
+    teams.reserve(points_.size());
+    for (auto it = points_.rbegin(); it != points_.rend(); ++it) {
+        teams.push_back(ScoredTeam{Team{}, it->second.offensiveScore(), it->second.defensiveScore(), it->second.members()});
+    }
+    return teams;
+}
+
+std::vector<ScoredTeam> rankFrontier(const std::vector<ScoredTeam>& frontier, const RankingPolicy& ranking) {
+    std::vector<std::pair<RankKey, size_t>> keys;
+    keys.reserve(frontier.size());
+    for (size_t i = 0; i < frontier.size(); ++i) {
+        keys.emplace_back(RankKey(ranking, frontier[i].offensiveScore, frontier[i].defensiveScore, frontier[i].members), i);
+    }
+    std::sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<ScoredTeam> ranked;
+    ranked.reserve(keys.size());
+    for (const auto& [key, index] : keys) ranked.push_back(frontier[index]);
+    return ranked;
+}
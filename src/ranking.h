@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "team.h"
+
+// How teams are ranked: by the combined score offenseWeight * offense + defenseWeight * defense,
+// ties going to the higher offense, then the higher defense, then the greater member indices.
+// One policy drives the top-N collection, the branch-and-bound cut-offs and the result order.
+// Weights must be finite and non-negative, or the search bounds would no longer be bounds.
+struct RankingPolicy {
+    double offenseWeight = 1.0;
+    double defenseWeight = 4.0;
+
+    constexpr double combine(double offense, double defense) const {
+        return offenseWeight * offense + defenseWeight * defense;
+    }
+    bool valid() const;
+    constexpr bool operator==(const RankingPolicy& other) const {
+        return offenseWeight == other.offenseWeight && defenseWeight == other.defenseWeight;
+    }
+    constexpr bool operator!=(const RankingPolicy& other) const { return !(*this == other); }
+};
+
+// A weighting fixed at compile time, so search code instantiated for it has the weights folded
+// into its arithmetic. Combines exactly like the equal RankingPolicy.
+template <int OffenseWeight, int DefenseWeight>
+struct FixedRanking {
+    static constexpr RankingPolicy policy{OffenseWeight, DefenseWeight};
+    static constexpr double combine(double offense, double defense) {
+        return OffenseWeight * offense + DefenseWeight * defense;
+    }
+};
+
+using StandardRanking = FixedRanking<1, 4>; // the default: offense plus four times defense
+using BalancedRanking = FixedRanking<1, 1>;
+using OffenseRanking = FixedRanking<1, 0>;
+
+// Calls f with the FixedRanking equal to a policy, or with the policy itself for other weightings
+template <typename F>
+decltype(auto) withRanking(const RankingPolicy& policy, F&& f) {
+    if (policy == StandardRanking::policy) return f(StandardRanking{});
+    if (policy == BalancedRanking::policy) return f(BalancedRanking{});
+    if (policy == OffenseRanking::policy) return f(OffenseRanking{});
+    return f(policy);
+}
+
+// Everything teams are ranked by, packed into integers so two teams compare with a few word
+// compares and no allocation. Orders like (combined score, offensiveScore, defensiveScore,
+// members) under the ranking it was built with: see RankingPolicy.
+// Scores are stored as order-preserving bit patterns of their doubles, so they decode exactly.
+class RankKey {
+public:
+    RankKey() = default;
+    template <typename Ranking>
+    RankKey(const Ranking& ranking, double offensiveScore, double defensiveScore, const TeamIndices& members)
+        : RankKey(ranking.combine(offensiveScore, defensiveScore), offensiveScore, defensiveScore, members) {}
+    // Ranks above every key with the same scores: for deciding on scores before members are known
+    template <typename Ranking>
+    static RankKey bestWithScores(const Ranking& ranking, double offensiveScore, double defensiveScore) {
+        return bestWithCombined(ranking.combine(offensiveScore, defensiveScore), offensiveScore, defensiveScore);
+    }
+    // The same scores with other members
+    RankKey withMembers(const TeamIndices& members) const;
+
+    double combinedScore() const;
+    double offensiveScore() const;
+    double defensiveScore() const;
+    TeamIndices members() const;
+
+    bool operator<(const RankKey& other) const { return words_ < other.words_; }
+    bool operator>(const RankKey& other) const { return other.words_ < words_; }
+    bool operator==(const RankKey& other) const { return words_ == other.words_; }
+
+private:
+    RankKey(double combinedScore, double offensiveScore, double defensiveScore, const TeamIndices& members);
+    static RankKey bestWithCombined(double combinedScore, double offensiveScore, double defensiveScore);
+
+    static_assert(kMaxTeamSize <= 6, "Member slots are packed into words 3 and 4");
+    // Combined, offense and defense; slots 0-3; slots 4-5 and the member count
+    std::array<uint64_t, 5> words_{};
+};
+
+// Keeps the best `capacity` teams offered to it, as a min-heap of RankKeys in one array with the
+// worst kept team at the front. Offers compare packed keys and don't allocate once the array
+// has reached capacity. Instances filled by separate workers merge into the same top teams a
+// single instance would have kept, since keys are a strict total order.
+class TopTeams {
+public:
+    explicit TopTeams(size_t capacity);
+
+    size_t capacity() const { return capacity_; }
+    size_t size() const { return keys_.size(); }
+    bool empty() const { return keys_.empty(); }
+    bool full() const { return keys_.size() == capacity_; }
+    // Lowest-ranked team kept. Only while !empty().
+    const RankKey& worst() const { return keys_.front(); }
+
+    // Whether offer(key) would keep the team
+    bool accepts(const RankKey& key) const { return !full() || (capacity_ > 0 && key > worst()); }
+    // Whether a team with these scores could be kept, whatever its members
+    template <typename Ranking>
+    bool couldAccept(const Ranking& ranking, double offensiveScore, double defensiveScore) const {
+        return accepts(RankKey::bestWithScores(ranking, offensiveScore, defensiveScore));
+    }
+    // Whether the team is kept already. Linear in the kept teams: for searches that may reach a team twice.
+    bool contains(const RankKey& key) const;
+    // Keeps the team if it ranks among the best `capacity`, evicting the worst
+    bool offer(const RankKey& key);
+    void merge(const TopTeams& other);
+
+    // Kept teams, best first by the ranking their keys were built with, with roster indices and
+    // scores but no Team
+    std::vector<ScoredTeam> results() const;
+    // Kept keys in heap order
+    const std::vector<RankKey>& keys() const { return keys_; }
+
+private:
+    // Entries allocated up front; larger capacities grow into place as teams arrive
+    static constexpr size_t kReservedEntries = 4096;
+
+    size_t capacity_;
+    std::vector<RankKey> keys_;
+};
+
+// The teams no other team beats on both scores: for every kept team, each other kept team has
+// strictly higher offense and lower defense or the reverse. A team that only ties a kept one on
+// both scores replaces it if its key ranks higher, so each point keeps the same team a top-N
+// search would. Points are held by offense, with defense then strictly decreasing, so whether a
+// team is dominated is one ordered lookup and an offer is O(log n) plus the points it removes.
+// Like TopTeams, instances filled by separate workers merge into the same frontier.
+class ParetoFrontier {
+public:
+    size_t size() const { return points_.size(); }
+    bool empty() const { return points_.empty(); }
+
+    // Whether some kept team scores at least as high on both and differs on one: no team with
+    // these scores, or below them, can join
+    bool dominated(double offensiveScore, double defensiveScore) const;
+    // Whether a team with these scores could be kept, whatever its members. Any ranking with
+    // non-negative weights ranks a frontier team first, so the ranking plays no part.
+    template <typename Ranking>
+    bool couldAccept(const Ranking&, double offensiveScore, double defensiveScore) const {
+        return !dominated(offensiveScore, defensiveScore);
+    }
+    // Keeps the team if nothing kept dominates it, dropping the teams it dominates
+    bool offer(const RankKey& key);
+    void merge(const ParetoFrontier& other);
+
+    // Kept teams by descending offense (so ascending defense), with roster indices and scores but no Team
+    std::vector<ScoredTeam> results() const;
+
+private:
+    std::map<double, RankKey> points_; // by offensive score
+};
+
+// A frontier's teams best first under a ranking. The first is the best team of the whole search
+// under that ranking whenever its weights are non-negative; the rest are the other trade-offs,
+// not necessarily the ranking's next best teams.
+std::vector<ScoredTeam> rankFrontier(const std::vector<ScoredTeam>& frontier, const RankingPolicy& ranking);
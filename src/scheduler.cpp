@@ -0,0 +1,137 @@
+#include <chrono>
+#include <thread>
+#include <utility>
+#include "scheduler.h"
+
+namespace { // file-local aliases
+    using Clock = std::chrono::steady_clock;
+}
+
+size_t SchedulerStats::totalTasks() const {
+    size_t total = 0;
+    for (const auto& worker : workers) total += worker.tasksExecuted;
+    return total;
+}
+
+size_t SchedulerStats::totalSteals() const {
+    size_t total = 0;
+    for (const auto& worker : workers) total += worker.steals;
+    return total;
+}
+
+double SchedulerStats::totalIdleSeconds() const {
+    double total = 0.0;
+    for (const auto& worker : workers) total += worker.idleSeconds;
+    return total;
+}
+
+WorkStealingScheduler::WorkStealingScheduler(size_t workerCount) {
+    if (workerCount == 0) workerCount = 1;
+    for (size_t i = 0; i < workerCount; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    stats_.workers.resize(workerCount);
+}
+
+void WorkStealingScheduler::submit(Task task) {
+    spawn(nextSubmit_, std::move(task));
+    nextSubmit_ = (nextSubmit_ + 1) % queues_.size();
+}
+
+void WorkStealingScheduler::spawn(size_t workerId, Task task) {
+    pendingTasks_.fetch_add(1);
+    {
+        WorkerQueue& queue = *queues_[workerId];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        spawnCount_.fetch_add(1);
+    }
+    workAvailable_.notify_one();
+}
+
+bool WorkStealingScheduler::popLocal(size_t workerId, Task& task) {
+    WorkerQueue& queue = *queues_[workerId];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingScheduler::steal(size_t workerId, Task& task) {
+    // Start with the neighbour so thieves don't all hit worker 0
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(workerId + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingScheduler::workerLoop(size_t workerId) {
+    WorkerStats& stats = stats_.workers[workerId];
+    Task task;
+    while (true) {
+        // Read before scanning, so a spawn that lands after the scan still wakes us
+        const size_t seenSpawns = spawnCount_.load();
+        if (popLocal(workerId, task)) {
+            // fall through to run it
+        } else if (steal(workerId, task)) {
+            ++stats.steals;
+        } else {
+            // Nothing queued anywhere. Finished once no task is running that could still spawn more.
+            const auto idleStart = Clock::now();
+            std::unique_lock<std::mutex> lock(idleMutex_);
+            workAvailable_.wait(lock, [&]() {
+                return pendingTasks_.load() == 0 || spawnCount_.load() != seenSpawns;
+            });
+            const bool finished = pendingTasks_.load() == 0;
+            lock.unlock();
+            stats.idleSeconds += std::chrono::duration<double>(Clock::now() - idleStart).count();
+            if (finished) return;
+            continue;
+        }
+
+        // After a failure the remaining tasks are drained without running them
+        if (!failed_.load()) {
+            try {
+                task(workerId);
+                ++stats.tasksExecuted;
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex_);
+                if (!failure_) failure_ = std::current_exception();
+                failed_ = true;
+            }
+        }
+        task = nullptr;
+        if (pendingTasks_.fetch_sub(1) == 1) {
+            // Last task done: wake every parked worker so it can return
+            { std::lock_guard<std::mutex> lock(idleMutex_); }
+            workAvailable_.notify_all();
+        }
+    }
+}
+
+void WorkStealingScheduler::run() {
+    std::vector<std::thread> workers;
+    workers.reserve(queues_.size() - 1);
+    for (size_t workerId = 1; workerId < queues_.size(); ++workerId) {
+        workers.emplace_back([this, workerId]() { workerLoop(workerId); });
+    }
+    // The calling thread works as worker 0
+    workerLoop(0);
+    for (auto& worker : workers) worker.join();
+
+    if (failure_) {
+        std::exception_ptr failure = failure_;
+        failure_ = nullptr;
+        failed_ = false;
+        std::rethrow_exception(failure);
+    }
+}
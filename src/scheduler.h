@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Counters for one worker of a WorkStealingScheduler run
+struct WorkerStats {
+    size_t tasksExecuted = 0;
+    size_t steals = 0;        // tasks this worker took from another worker's deque
+    double idleSeconds = 0.0; // time spent parked with no work available
+};
+
+struct SchedulerStats {
+    std::vector<WorkerStats> workers;
+
+    size_t totalTasks() const;
+    size_t totalSteals() const;
+    double totalIdleSeconds() const;
+};
+
+// Work-stealing task pool. Every worker owns a deque: it pushes and pops its own tasks
+// at the back (depth-first, cache friendly) and steals from the front of other workers'
+// deques (oldest, and for a search tree usually the largest, subtrees) when it runs dry.
+class WorkStealingScheduler {
+public:
+    // A task receives the id of the worker running it, in [0, workerCount)
+    using Task = std::function<void(size_t workerId)>;
+
+    explicit WorkStealingScheduler(size_t workerCount);
+
+    // Queues a task before run(). Tasks are dealt round-robin across workers.
+    void submit(Task task);
+    // Queues a task on the calling worker's own deque. Only valid from inside a running task.
+    void spawn(size_t workerId, Task task);
+
+    // Runs until every submitted and spawned task has finished. If a task throws, the tasks
+    // still queued are dropped and the first exception is rethrown once every worker has stopped.
+    void run();
+
+    size_t workerCount() const { return queues_.size(); }
+    const SchedulerStats& stats() const { return stats_; }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool popLocal(size_t workerId, Task& task);
+    bool steal(size_t workerId, Task& task);
+    void workerLoop(size_t workerId);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::atomic<size_t> pendingTasks_{0};
+    // Idle workers park on workAvailable_; spawnCount_ changes under idleMutex_ so a worker
+    // that found every deque empty can tell whether a task arrived since it looked
+    std::mutex idleMutex_;
+    std::condition_variable workAvailable_;
+    std::atomic<size_t> spawnCount_{0};
+    std::mutex failureMutex_;
+    std::exception_ptr failure_;
+    std::atomic<bool> failed_{false};
+    size_t nextSubmit_ = 0;
+    SchedulerStats stats_;
+};
@@ -0,0 +1,449 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include "intern.h"
+#include "logger.h"
+#include "snapshot.h"
+#include "team.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace { // file-local layout, file mapping and record readers
+    using std::runtime_error;
+    using std::string;
+    using std::vector;
+
+    constexpr char kMagic[8] = {'T', 'E', 'A', 'M', 'S', 'N', 'A', 'P'};
+    constexpr uint32_t kByteOrderMark = 0x01020304;
+    constexpr uint32_t kNoString = std::numeric_limits<uint32_t>::max();
+    constexpr uint8_t kNoType = std::numeric_limits<uint8_t>::max();
+
+    enum Section : size_t {
+        StringOffsets, // uint32 start of every string in StringBytes, plus the end of the last
+        StringBytes,   // char, names back to back
+        Abilities,     // AbilityRecord
+        Members,       // MemberRecord, the pokemon
+        Targets,       // MemberRecord, unnamed
+        AbilityRefs,   // uint32 string index; each record's abilities are a run of these
+        TypeChart,     // double, [attacker][defender]
+        Coverage,      // uint64, [attacking type][word] of the target coverage
+        kSectionCount
+    };
+
+    struct SectionEntry {
+        uint64_t offset; // from the start of the file, a multiple of 8
+        uint64_t count;  // elements
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t typeCount;
+        uint32_t reserved;
+        uint64_t fileSize;
+        SectionEntry sections[kSectionCount];
+        uint64_t sourceSizes[4];
+        uint64_t sourceHashes[4];
+    };
+
+    struct AbilityRecord {
+        uint32_t name;
+        uint32_t immuneTo;
+        uint32_t multipliedTypes;
+        uint8_t immuneUnlessSuperEffective;
+        uint8_t scalesSuperEffective;
+        uint8_t padding[2];
+        double superEffectiveMultiplier;
+        double multiplier[NUM_TYPES];
+    };
+
+    struct MemberRecord {
+        uint32_t name;         // kNoString for targets
+        uint32_t firstAbility; // into AbilityRefs
+        uint16_t abilityCount;
+        uint8_t primaryType;
+        uint8_t secondaryType; // kNoType when single-typed
+    };
+
+    static_assert(std::is_trivially_copyable<Header>::value && std::is_trivially_copyable<AbilityRecord>::value &&
+        std::is_trivially_copyable<MemberRecord>::value, "Snapshot records are copied as bytes");
+    static_assert(sizeof(MemberRecord) == 12 && sizeof(AbilityRecord) % 8 == 0, "Snapshot records are packed");
+
+    // Sections are appended 8-byte aligned after the header, which is filled in last
+    class SnapshotBuilder {
+    public:
+        explicit SnapshotBuilder(const SourceFingerprint& sources) : bytes_(sizeof(Header), 0) {
+            std::copy(sources.sizes.begin(), sources.sizes.end(), header_.sourceSizes);
+            std::copy(sources.hashes.begin(), sources.hashes.end(), header_.sourceHashes);
+        }
+
+        template <typename T>
+        void append(Section section, const vector<T>& items) {
+            bytes_.resize((bytes_.size() + 7) / 8 * 8, 0);
+            header_.sections[section] = SectionEntry{bytes_.size(), items.size()};
+            const auto* begin = reinterpret_cast<const unsigned char*>(items.data());
+            bytes_.insert(bytes_.end(), begin, begin + items.size() * sizeof(T));
+        }
+
+        const vector<unsigned char>& finish() {
+            std::memcpy(header_.magic, kMagic, sizeof(kMagic));
+            header_.version = kSnapshotVersion;
+            header_.byteOrder = kByteOrderMark;
+            header_.typeCount = static_cast<uint32_t>(NUM_TYPES);
+            header_.fileSize = bytes_.size();
+            std::memcpy(bytes_.data(), &header_, sizeof(Header));
+            return bytes_;
+        }
+
+    private:
+        Header header_{};
+        vector<unsigned char> bytes_;
+    };
+
+    // Read-only mapping of a whole file, released on destruction
+    class MappedFile {
+    public:
+        explicit MappedFile(const string& path) {
+#if defined(_WIN32)
+            file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) throw runtime_error("Could not open snapshot file: " + path);
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file_, &size)) {
+                release();
+                throw runtime_error("Could not read the size of snapshot file: " + path);
+            }
+            size_ = static_cast<size_t>(size.QuadPart);
+            if (size_ > 0) {
+                mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping_) data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+                if (!data_) {
+                    release();
+                    throw runtime_error("Could not map snapshot file: " + path);
+                }
+            }
+#else
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw runtime_error("Could not open snapshot file: " + path);
+            struct stat info;
+            if (fstat(fd, &info) != 0) {
+                close(fd);
+                throw runtime_error("Could not read the size of snapshot file: " + path);
+            }
+            size_ = static_cast<size_t>(info.st_size);
+            if (size_ > 0) {
+                void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    close(fd);
+                    throw runtime_error("Could not map snapshot file: " + path);
+                }
+                data_ = static_cast<const unsigned char*>(mapped);
+            }
+            close(fd);
+#endif
+        }
+        ~MappedFile() { release(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const unsigned char* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        void release() {
+#if defined(_WIN32)
+            if (data_) UnmapViewOfFile(data_);
+            if (mapping_) CloseHandle(mapping_);
+            if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+            file_ = INVALID_HANDLE_VALUE;
+            mapping_ = nullptr;
+#else
+            if (data_) munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+            data_ = nullptr;
+        }
+
+#if defined(_WIN32)
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#endif
+        const unsigned char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    // Records of one section, read in place from the mapping
+    template <typename T>
+    struct SectionView {
+        const T* items;
+        size_t count;
+        const T& operator[](size_t i) const { return items[i]; }
+    };
+
+    // Reads the mapped records back into objects. Every index is checked before it's followed.
+    class SnapshotReader {
+    public:
+        SnapshotReader(const MappedFile& file, const string& path) : file_(file), path_(path) {
+            if (file.size() < sizeof(Header)) throw runtime_error("Not a snapshot file: " + path);
+            std::memcpy(&header_, file.data(), sizeof(Header));
+            if (std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0) throw runtime_error("Not a snapshot file: " + path);
+            if (header_.byteOrder != kByteOrderMark) throw runtime_error("Snapshot written with another byte order: " + path);
+            if (header_.version != kSnapshotVersion) {
+                throw runtime_error("Snapshot version " + std::to_string(header_.version) + " of " + path +
+                    " can't be read, expected " + std::to_string(kSnapshotVersion));
+            }
+            if (header_.typeCount != NUM_TYPES) throw runtime_error("Snapshot built for another type list: " + path);
+            if (header_.fileSize != file.size()) throw runtime_error("Truncated snapshot file: " + path);
+
+            stringOffsets_ = section<uint32_t>(StringOffsets);
+            stringBytes_ = section<char>(StringBytes);
+            abilityRefs_ = section<uint32_t>(AbilityRefs);
+            if (stringOffsets_.count == 0) corrupt("string table");
+            for (size_t i = 0; i + 1 < stringOffsets_.count; ++i) {
+                if (stringOffsets_[i] > stringOffsets_[i + 1]) corrupt("string table");
+            }
+            if (stringOffsets_[stringOffsets_.count - 1] > stringBytes_.count) corrupt("string table");
+            abilityIds_.assign(stringOffsets_.count - 1, kUnresolved);
+        }
+
+        SourceFingerprint sources() const {
+            SourceFingerprint sources;
+            std::copy(header_.sourceSizes, header_.sourceSizes + 4, sources.sizes.begin());
+            std::copy(header_.sourceHashes, header_.sourceHashes + 4, sources.hashes.begin());
+            return sources;
+        }
+
+        template <typename T>
+        SectionView<T> section(Section section) const {
+            const SectionEntry& entry = header_.sections[section];
+            if (entry.offset % alignof(T) != 0 || entry.offset > file_.size() ||
+                entry.count > (file_.size() - entry.offset) / sizeof(T)) {
+                corrupt("section " + std::to_string(static_cast<size_t>(section)));
+            }
+            return SectionView<T>{reinterpret_cast<const T*>(file_.data() + entry.offset), static_cast<size_t>(entry.count)};
+        }
+
+        // Views the mapping: intern it to keep it past the load
+        std::string_view stringAt(uint32_t index) const {
+            if (index + size_t{1} >= stringOffsets_.count) corrupt("string index");
+            return std::string_view(stringBytes_.items + stringOffsets_[index], stringOffsets_[index + 1] - stringOffsets_[index]);
+        }
+
+        Type typeAt(uint8_t value) const {
+            if (value >= NUM_TYPES) corrupt("type");
+            return static_cast<Type>(value);
+        }
+
+        // Types and abilities of a Pokemon or TypeAbilityCombo. Each ability is interned once per load.
+        template <typename Entry>
+        void readMember(const MemberRecord& record, Entry& entry) {
+            entry.primaryType = typeAt(record.primaryType);
+            if (record.secondaryType != kNoType) entry.secondaryType = typeAt(record.secondaryType);
+            if (record.firstAbility > abilityRefs_.count || record.abilityCount > abilityRefs_.count - record.firstAbility ||
+                record.abilityCount > kMaxAbilities) {
+                corrupt("ability run");
+            }
+            for (size_t i = record.firstAbility; i < record.firstAbility + size_t{record.abilityCount}; ++i) {
+                const uint32_t name = abilityRefs_[i];
+                if (name + size_t{1} >= stringOffsets_.count) corrupt("ability reference");
+                if (abilityIds_[name] == kUnresolved) abilityIds_[name] = internAbility(stringAt(name));
+                entry.abilities.push_back(static_cast<AbilityId>(abilityIds_[name]));
+            }
+        }
+
+        [[noreturn]] void corrupt(const string& what) const {
+            throw runtime_error("Corrupt snapshot " + what + " in " + path_);
+        }
+
+    private:
+        static constexpr uint32_t kUnresolved = std::numeric_limits<uint32_t>::max();
+
+        const MappedFile& file_;
+        const string& path_;
+        Header header_;
+        SectionView<uint32_t> stringOffsets_{};
+        SectionView<char> stringBytes_{};
+        SectionView<uint32_t> abilityRefs_{};
+        vector<uint32_t> abilityIds_; // [string index]: its AbilityId once interned
+    };
+}
+
+SourceFingerprint fingerprintSources(
+    const string& pokemonPath,
+    const string& typeChartPath,
+    const string& abilityEffectsPath,
+    const string& targetsPath
+) {
+    SourceFingerprint fingerprint;
+    const string* paths[] = {&pokemonPath, &typeChartPath, &abilityEffectsPath, &targetsPath};
+    for (size_t i = 0; i < 4; ++i) {
+        std::ifstream file(*paths[i], std::ios::binary);
+        if (!file.is_open()) throw runtime_error("Could not open file: " + *paths[i]);
+        uint64_t hash = 0xcbf29ce484222325; // FNV-1a offset basis
+        uint64_t size = 0;
+        char buffer[1 << 16];
+        while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+            const size_t count = static_cast<size_t>(file.gcount());
+            for (size_t b = 0; b < count; ++b) {
+                hash = (hash ^ static_cast<unsigned char>(buffer[b])) * 0x100000001b3;
+            }
+            size += count;
+        }
+        if (file.bad()) throw runtime_error("Failed to read file: " + *paths[i]);
+        fingerprint.sizes[i] = size;
+        fingerprint.hashes[i] = hash;
+    }
+    return fingerprint;
+}
+
+GameData loadGameData(
+    const string& pokemonPath,
+    const string& typeChartPath,
+    const string& abilityEffectsPath,
+    const string& targetsPath
+) {
+    GameData data;
+    data.pokemon = loadPokemon(pokemonPath);
+    data.typeChart = loadTypeEffectiveness(typeChartPath);
+    data.abilityEffects = loadAbilityEffects(abilityEffectsPath);
+    data.targets = loadTypeAbilityCombos(targetsPath);
+    data.targetCoverage = TeamEvaluator(data.typeChart, data.abilityEffects, data.targets).typeCoverage();
+    return data;
+}
+
+void writeSnapshot(const GameData& data, const SourceFingerprint& sources, const string& path) {
+    Logger::info("Writing snapshot to: " + path);
+
+    // Every name once, keyed by its interned view; string i spans [offsets[i], offsets[i + 1]) of the bytes
+    std::unordered_map<std::string_view, uint32_t> stringIds;
+    vector<uint32_t> stringOffsets{0};
+    vector<char> stringBytes;
+    auto intern = [&](std::string_view name) {
+        const auto [it, added] = stringIds.emplace(name, static_cast<uint32_t>(stringIds.size()));
+        if (added) {
+            stringBytes.insert(stringBytes.end(), name.begin(), name.end());
+            if (stringBytes.size() >= kNoString) throw runtime_error("Too many names for a snapshot");
+            stringOffsets.push_back(static_cast<uint32_t>(stringBytes.size()));
+        }
+        return it->second;
+    };
+
+    vector<AbilityRecord> abilities;
+    const auto& effects = data.abilityEffects.byId();
+    for (size_t id = 0; id < effects.size(); ++id) {
+        const AbilityEffect& effect = effects[id];
+        AbilityRecord record{};
+        record.name = intern(abilityName(static_cast<AbilityId>(id)));
+        record.immuneTo = effect.immuneTo;
+        record.multipliedTypes = effect.multipliedTypes;
+        record.immuneUnlessSuperEffective = effect.immuneUnlessSuperEffective;
+        record.scalesSuperEffective = effect.scalesSuperEffective;
+        record.superEffectiveMultiplier = effect.superEffectiveMultiplier;
+        std::copy(effect.multiplier.begin(), effect.multiplier.end(), record.multiplier);
+        abilities.push_back(record);
+    }
+
+    vector<uint32_t> abilityRefs;
+    auto memberRecord = [&](uint32_t name, Type primaryType, const std::optional<Type>& secondaryType, const AbilityList& abilities) {
+        MemberRecord record{name, static_cast<uint32_t>(abilityRefs.size()), static_cast<uint16_t>(abilities.size()),
+            static_cast<uint8_t>(primaryType), secondaryType ? static_cast<uint8_t>(*secondaryType) : kNoType};
+        for (const AbilityId ability : abilities) abilityRefs.push_back(intern(abilityName(ability)));
+        return record;
+    };
+    vector<MemberRecord> members;
+    for (const auto& p : data.pokemon) members.push_back(memberRecord(intern(p.name), p.primaryType, p.secondaryType, p.abilities));
+    vector<MemberRecord> targets;
+    for (const auto& t : data.targets) targets.push_back(memberRecord(kNoString, t.primaryType, t.secondaryType, t.abilities));
+
+    vector<double> chart;
+    for (const auto& row : data.typeChart) chart.insert(chart.end(), row.begin(), row.end());
+    vector<uint64_t> coverage;
+    for (const auto& typeCoverage : data.targetCoverage) {
+        if (typeCoverage.size() != data.targets.size()) throw runtime_error("Target coverage doesn't match the target list");
+        coverage.insert(coverage.end(), typeCoverage.words().begin(), typeCoverage.words().end());
+    }
+
+    SnapshotBuilder builder(sources);
+    builder.append(StringOffsets, stringOffsets);
+    builder.append(StringBytes, stringBytes);
+    builder.append(Abilities, abilities);
+    builder.append(Members, members);
+    builder.append(Targets, targets);
+    builder.append(AbilityRefs, abilityRefs);
+    builder.append(TypeChart, chart);
+    builder.append(Coverage, coverage);
+    const vector<unsigned char>& bytes = builder.finish();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) throw runtime_error("Could not open snapshot file for writing: " + path);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) throw runtime_error("Failed to write snapshot file: " + path);
+}
+
+GameData loadSnapshot(const string& path) {
+    Logger::info("Loading snapshot from: " + path);
+    const MappedFile file(path);
+    SnapshotReader reader(file, path);
+    GameData data;
+
+    const auto abilities = reader.section<AbilityRecord>(Abilities);
+    for (size_t i = 0; i < abilities.count; ++i) {
+        const AbilityRecord& record = abilities[i];
+        AbilityEffect effect;
+        effect.immuneTo = record.immuneTo;
+        effect.immuneUnlessSuperEffective = record.immuneUnlessSuperEffective != 0;
+        effect.multipliedTypes = record.multipliedTypes;
+        std::copy(record.multiplier, record.multiplier + NUM_TYPES, effect.multiplier.begin());
+        effect.scalesSuperEffective = record.scalesSuperEffective != 0;
+        effect.superEffectiveMultiplier = record.superEffectiveMultiplier;
+        data.abilityEffects.set(reader.stringAt(record.name), effect);
+    }
+
+    const auto members = reader.section<MemberRecord>(Members);
+    data.pokemon.resize(members.count);
+    for (size_t i = 0; i < members.count; ++i) {
+        data.pokemon[i].name = internName(reader.stringAt(members[i].name));
+        reader.readMember(members[i], data.pokemon[i]);
+    }
+    const auto targets = reader.section<MemberRecord>(Targets);
+    data.targets.resize(targets.count);
+    for (size_t i = 0; i < targets.count; ++i) reader.readMember(targets[i], data.targets[i]);
+
+    const auto chart = reader.section<double>(TypeChart);
+    if (chart.count != NUM_TYPES * NUM_TYPES) reader.corrupt("type chart");
+    for (size_t attacker = 0; attacker < NUM_TYPES; ++attacker) {
+        std::copy(chart.items + attacker * NUM_TYPES, chart.items + (attacker + 1) * NUM_TYPES, data.typeChart[attacker].begin());
+    }
+
+    const size_t words = (data.targets.size() + 63) / 64;
+    const auto coverage = reader.section<uint64_t>(Coverage);
+    if (coverage.count != NUM_TYPES * words) reader.corrupt("target coverage");
+    for (size_t t = 0; t < NUM_TYPES; ++t) {
+        data.targetCoverage[t] = CoverageSet(data.targets.size(), coverage.items + t * words);
+    }
+
+    Logger::info("Loaded " + std::to_string(data.pokemon.size()) + " Pokemon and " +
+        std::to_string(data.targets.size()) + " targets from snapshot.");
+    return data;
+}
+
+SourceFingerprint snapshotSources(const string& path) {
+    const MappedFile file(path);
+    return SnapshotReader(file, path).sources();
+}
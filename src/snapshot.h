@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "abilities.h"
+#include "pokemon.h"
+#include "profile.h"
+#include "types.h"
+
+// Everything one run reads from the data files, plus the per-attacking-type target coverage a
+// TeamEvaluator derives from them. A TeamEvaluator built over these members keeps references into it.
+struct GameData {
+    PokemonList pokemon;
+    TypeEffectiveness typeChart;
+    AbilityEffects abilityEffects;
+    TypeAbilityComboList targets;
+    std::array<CoverageSet, NUM_TYPES> targetCoverage; // [attacking type]: targets it hits super effectively
+};
+
+// Loads the JSON data files and derives targetCoverage from them
+GameData loadGameData(
+    const std::string& pokemonPath,
+    const std::string& typeChartPath,
+    const std::string& abilityEffectsPath,
+    const std::string& targetsPath
+);
+
+// Size and content hash (64-bit FNV-1a) of each JSON file a GameData was loaded from,
+// in loadGameData's argument order
+struct SourceFingerprint {
+    std::array<uint64_t, 4> sizes{};
+    std::array<uint64_t, 4> hashes{};
+
+    bool operator==(const SourceFingerprint& other) const { return sizes == other.sizes && hashes == other.hashes; }
+    bool operator!=(const SourceFingerprint& other) const { return !(*this == other); }
+};
+
+// Throws std::runtime_error when a file can't be read
+SourceFingerprint fingerprintSources(
+    const std::string& pokemonPath,
+    const std::string& typeChartPath,
+    const std::string& abilityEffectsPath,
+    const std::string& targetsPath
+);
+
+// Binary snapshot of a GameData, produced from the JSON once and memory-mapped at startup.
+// A header (magic, version, byte order, type count, size, section table and the fingerprint
+// of the JSON files it was built from) is followed by 8-byte aligned
+// sections: a string table of member and ability names, ability effect records, packed member
+// and target records (type bytes plus a run of ability references into the string table), the
+// type chart and the target coverage words. Loading validates the header and every section's
+// bounds and builds the GameData straight from the mapped records, without parsing.
+constexpr uint32_t kSnapshotVersion = 2;
+
+// Throws std::runtime_error when the file can't be written, or a list is too large for the format
+void writeSnapshot(const GameData& data, const SourceFingerprint& sources, const std::string& path);
+// Throws std::runtime_error for a missing or truncated file, or one that isn't a snapshot of
+// this version, byte order and type list
+GameData loadSnapshot(const std::string& path);
+// The fingerprint stored by writeSnapshot, read from the header alone. Throws like loadSnapshot.
+// A snapshot is only current while this equals fingerprintSources() of its JSON files.
+SourceFingerprint snapshotSources(const std::string& path);
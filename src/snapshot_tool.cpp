@@ -0,0 +1,32 @@
+#include <exception>
+#include <iostream>
+#include "logger.h"
+#include "snapshot.h"
+
+// Builds a binary snapshot from the JSON data files:
+//   team_snapshot <pokemon.json> <typeChart.json> <abilityEffects.json> <type_ability_combos.json> <out.snapshot>
+int main(int argc, char** argv) {
+    Logger::setLogLevel(LogLevel::Info);
+    if (argc != 6) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <pokemon.json> <typeChart.json> <abilityEffects.json> <type_ability_combos.json> <out.snapshot>\n";
+        return 2;
+    }
+
+    try {
+        // Fingerprinted first: an edit during the load then makes the snapshot look stale, not current
+        const SourceFingerprint sources = fingerprintSources(argv[1], argv[2], argv[3], argv[4]);
+        const GameData data = loadGameData(argv[1], argv[2], argv[3], argv[4]);
+        writeSnapshot(data, sources, argv[5]);
+        // Read it back so a broken snapshot fails here rather than at the next startup
+        const GameData check = loadSnapshot(argv[5]);
+        if (check.pokemon.size() != data.pokemon.size() || check.targets.size() != data.targets.size()) {
+            std::cerr << "Snapshot read back with different contents: " << argv[5] << "\n";
+            return 1;
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,8 +1,48 @@
+#include <stdexcept>
 #include "team.h"
 #include "logger.h"
 
 using std::vector;
 
+namespace { // file-local helpers
+    const TypeAbilityComboList kNoTargets;
+}
+
+TeamEvaluator::TeamEvaluator(const TypeEffectiveness& typeChart, const AbilityEffects& abilityEffects)
+    : TeamEvaluator(typeChart, abilityEffects, kNoTargets) {}
+
+TeamEvaluator::TeamEvaluator(const TypeEffectiveness& typeChart, const AbilityEffects& abilityEffects, const TypeAbilityComboList& targets)
+    : typeChart_(typeChart), abilityEffects_(abilityEffects), targets_(targets) {
+    typeCoverage_.fill(CoverageSet(targets.size()));
+    for (size_t t = 0; t < targets.size(); ++t) {
+        const TypeAbilityCombo& target = targets[t];
+        for (size_t attacker = 0; attacker < NUM_TYPES; ++attacker) {
+            const double eff = getTypeEffectiveness(
+                typeChart_,
+                abilityEffects_,
+                static_cast<Type>(attacker),
+                target.primaryType,
+                target.abilities,
+                target.secondaryType
+            );
+            if (eff > 1.0) typeCoverage_[attacker].set(t);
+        }
+    }
+}
+
+TeamEvaluator::TeamEvaluator(
+    const TypeEffectiveness& typeChart,
+    const AbilityEffects& abilityEffects,
+    const TypeAbilityComboList& targets,
+    const std::array<CoverageSet, NUM_TYPES>& typeCoverage
+) : typeChart_(typeChart), abilityEffects_(abilityEffects), targets_(targets), typeCoverage_(typeCoverage) {
+    for (const auto& coverage : typeCoverage_) {
+        if (coverage.size() != targets.size()) {
+            throw std::invalid_argument("Type coverage doesn't match the target list");
+        }
+    }
+}
+
 // Evaluates the offensive coverage of a team against a list of target Pokemon.
 // The score increases by 1 for each unique Pokemon in the given list that any team member can hit super effectively (effectiveness > 1.0).
 double TeamEvaluator::evaluateOffense(const Team& team, const TypeAbilityComboList& targets) const {
@@ -11,25 +51,10 @@ double TeamEvaluator::evaluateOffense(const Team& team, const TypeAbilityComboLi
     for (const auto& target : targets) {
         bool canHitSE = false;
         for (const auto& member : team) {
-            // For each attacking type the member has...
-            vector<Type> attackerTypes = { member.primaryType };
-            if (member.secondaryType && member.secondaryType.value() != member.primaryType) {
-                attackerTypes.push_back(member.secondaryType.value());
-            }
-            for (const auto& atkType : attackerTypes) {
-                double eff = getTypeEffectiveness(
-                    typeChart_,
-                    atkType,
-                    target.primaryType,
-                    target.abilities,
-                    target.secondaryType
-                );
-                if (eff > 1.0) {
-                    canHitSE = true;
-                    break;
-                }
+            if (canHitSuperEffectively(member, target)) {
+                canHitSE = true;
+                break;
             }
-            if (canHitSE) break;
         }
         if (canHitSE) ++score;
     }
@@ -37,6 +62,80 @@ double TeamEvaluator::evaluateOffense(const Team& team, const TypeAbilityComboLi
     return static_cast<double>(score);
 }
 
+// Same score as above, from a team coverage set built out of precomputed member coverage.
+double TeamEvaluator::evaluateOffense(const CoverageSet& teamCoverage) const {
+    return static_cast<double>(teamCoverage.count());
+}
+
+// True if any of the member's attacking types is super effective (> 1.0) against the target
+bool TeamEvaluator::canHitSuperEffectively(const Pokemon& member, const TypeAbilityCombo& target) const {
+    // For each attacking type the member has...
+    vector<Type> attackerTypes = { member.primaryType };
+    if (member.secondaryType && member.secondaryType.value() != member.primaryType) {
+        attackerTypes.push_back(member.secondaryType.value());
+    }
+    for (const auto& atkType : attackerTypes) {
+        double eff = getTypeEffectiveness(
+            typeChart_,
+            abilityEffects_,
+            atkType,
+            target.primaryType,
+            target.abilities,
+            target.secondaryType
+        );
+        if (eff > 1.0) return true;
+    }
+    return false;
+}
+
+CoverageSet TeamEvaluator::buildCoverage(const Pokemon& member, const TypeAbilityComboList& targets) const {
+    CoverageSet coverage(targets.size());
+    for (size_t t = 0; t < targets.size(); ++t) {
+        if (canHitSuperEffectively(member, targets[t])) coverage.set(t);
+    }
+    return coverage;
+}
+
+DefenseProfile TeamEvaluator::buildDefenseProfile(const Pokemon& member) const {
+    DefenseProfile profile;
+    for (size_t t = 0; t < NUM_TYPES; ++t) {
+        double eff = getTypeEffectiveness(
+            typeChart_,
+            abilityEffects_,
+            static_cast<Type>(t),
+            member.primaryType,
+            member.abilities,
+            member.secondaryType
+        );
+        const FixedEffectiveness fixed = encodeEffectiveness(eff);
+        profile.effectiveness[t] = fixed;
+        profile.weakness[t] = (fixed > kEffectivenessScale) ? static_cast<FixedEffectiveness>(fixed - kEffectivenessScale) : 0;
+        profile.totalWeakness += profile.weakness[t];
+    }
+    return profile;
+}
+
+// A member hits a target super effectively when one of its types does
+CoverageSet TeamEvaluator::buildCoverage(const Pokemon& member) const {
+    CoverageSet coverage = typeCoverage_[static_cast<size_t>(member.primaryType)];
+    if (member.secondaryType) coverage.merge(typeCoverage_[static_cast<size_t>(*member.secondaryType)]);
+    return coverage;
+}
+
+MemberProfile TeamEvaluator::buildProfile(const Pokemon& member, const TypeAbilityComboList& targets) const {
+    return MemberProfile{ buildCoverage(member, targets), buildDefenseProfile(member) };
+}
+
+// Builds the per-member profile table for a pool. Index i of the result describes members[i].
+MemberProfileTable TeamEvaluator::buildProfiles(const PokemonList& members, const TypeAbilityComboList& targets) const {
+    MemberProfileTable profiles;
+    profiles.reserve(members.size());
+    for (const auto& member : members) {
+        profiles.push_back(buildProfile(member, targets));
+    }
+    return profiles;
+}
+
 // Defensive value calculation
 // For each attacking type: if the result is a 0.5 resistance, the defensive value will be increased by one point.
 // If it's a 0.25 resistance, it'll be increased by two.
@@ -52,6 +151,7 @@ double TeamEvaluator::evaluateDefense(const Team& team, const vector<Type>& atta
         for (const auto& member : team) {
             double eff = getTypeEffectiveness(
                 typeChart_,
+                abilityEffects_,
                 attacker,
                 member.primaryType,
                 member.abilities,
@@ -64,13 +164,26 @@ double TeamEvaluator::evaluateDefense(const Team& team, const vector<Type>& atta
             }
         }
         // Only add the best resistance/immunity for this attacking type
-        if (bestResist == 0.0 || bestResist == 0.25) {
-            score += 2.0;
-        } else if (bestResist == 0.5) {
-            score += 1.0;
-        }
-        // Neutral (1.0) or other values: no change
+        score += resistBonus(bestResist);
     }
     Logger::debug("Defensive score: " + std::to_string(score));
     return score;
 }
+
+// Same score as above over every attacking type, from accumulated member profiles.
+double TeamEvaluator::evaluateDefense(const TeamDefense& teamDefense) const {
+    return teamDefense.score();
+}
+
+MemberProfile TeamEvaluator::buildProfile(const Pokemon& member) const {
+    return MemberProfile{ buildCoverage(member), buildDefenseProfile(member) };
+}
+
+MemberProfileTable TeamEvaluator::buildProfiles(const PokemonList& members) const {
+    MemberProfileTable profiles;
+    profiles.reserve(members.size());
+    for (const auto& member : members) {
+        profiles.push_back(buildProfile(member));
+    }
+    return profiles;
+}
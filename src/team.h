@@ -1,31 +1,97 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <optional>
+#include "abilities.h"
 #include "pokemon.h"
+#include "profile.h"
 #include "types.h"
 
 using Team = std::vector<Pokemon>;
 
+constexpr size_t kMaxTeamSize = 6;
+
+// Team as indices into a member roster. Fixed capacity, so copying one never allocates.
+struct TeamIndices {
+    std::array<uint16_t, kMaxTeamSize> slots{};
+    uint8_t count = 0;
+
+    void push_back(size_t index) { slots[count++] = static_cast<uint16_t>(index); }
+    void pop_back() { --count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    // Sorts slots [from, size()). Insertion sort: there are at most kMaxTeamSize of them, and
+    // unlike std::sort over slots it leaves GCC no out-of-bounds path to warn about.
+    void sort(size_t from = 0) {
+        for (size_t i = from + 1; i < count; ++i) {
+            const uint16_t value = slots[i];
+            size_t j = i;
+            for (; j > from && slots[j - 1] > value; --j) slots[j] = slots[j - 1];
+            slots[j] = value;
+        }
+    }
+    const uint16_t* begin() const { return slots.data(); }
+    const uint16_t* end() const { return slots.data() + count; }
+    bool operator<(const TeamIndices& other) const {
+        return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+    }
+};
+
+// A team and its scores. Teams are ranked against each other by a RankingPolicy (ranking.h).
 struct ScoredTeam {
     Team team;
     double offensiveScore;
     double defensiveScore;
-    // For sorting. higher offense, then higher defense
-    bool operator<(const ScoredTeam& other) const {
-        return (offensiveScore + 4*defensiveScore) < (other.offensiveScore + 4*other.defensiveScore);
-    }
+    // Roster indices while the generator is searching; team is filled in only for the final results
+    TeamIndices members;
 };
 
+// Scores teams against a type chart and ability effects. An evaluator built with a target list
+// keeps a reference to it, like the chart, and precomputes once which targets each attacking
+// type hits super effectively, so profiles for any number of generation queries come from it.
 class TeamEvaluator {
 public:
-    TeamEvaluator(const TypeEffectiveness& typeChart)
-        : typeChart_(typeChart) {}
+    // No targets of its own: offense needs the explicit-target overloads
+    TeamEvaluator(const TypeEffectiveness& typeChart, const AbilityEffects& abilityEffects);
+    TeamEvaluator(const TypeEffectiveness& typeChart, const AbilityEffects& abilityEffects, const TypeAbilityComboList& targets);
+    // Same, with the per-type coverage already computed (e.g. stored in a snapshot with the targets)
+    TeamEvaluator(
+        const TypeEffectiveness& typeChart,
+        const AbilityEffects& abilityEffects,
+        const TypeAbilityComboList& targets,
+        const std::array<CoverageSet, NUM_TYPES>& typeCoverage
+    );
+
+    const TypeAbilityComboList& targets() const { return targets_; }
+    // [attacking type]: the targets() it hits super effectively
+    const std::array<CoverageSet, NUM_TYPES>& typeCoverage() const { return typeCoverage_; }
 
     double evaluateOffense(const Team& team, const TypeAbilityComboList& targets) const;
+    // Offense from a precomputed team coverage (OR of member coverage sets)
+    double evaluateOffense(const CoverageSet& teamCoverage) const;
     double evaluateDefense(const Team& team, const vector<Type>& attackingTypes) const;
+    // Defense against every attacking type from precomputed member profiles
+    double evaluateDefense(const TeamDefense& teamDefense) const;
+
+    // Precompute stage: which targets a member hits super effectively
+    CoverageSet buildCoverage(const Pokemon& member, const TypeAbilityComboList& targets) const;
+    DefenseProfile buildDefenseProfile(const Pokemon& member) const;
+    MemberProfile buildProfile(const Pokemon& member, const TypeAbilityComboList& targets) const;
+    MemberProfileTable buildProfiles(const PokemonList& members, const TypeAbilityComboList& targets) const;
+    // Same, against targets() from the precomputed per-type coverage
+    CoverageSet buildCoverage(const Pokemon& member) const;
+    MemberProfile buildProfile(const Pokemon& member) const;
+    MemberProfileTable buildProfiles(const PokemonList& members) const;
 
 private:
+    bool canHitSuperEffectively(const Pokemon& member, const TypeAbilityCombo& target) const;
+
     const TypeEffectiveness& typeChart_;
+    const AbilityEffects& abilityEffects_;
+    const TypeAbilityComboList& targets_;
+    std::array<CoverageSet, NUM_TYPES> typeCoverage_; // [attacking type]: targets it hits super effectively
 };
\ No newline at end of file
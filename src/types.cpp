@@ -2,6 +2,7 @@
 #include <nlohmann/json.hpp>
 #include <stdexcept>
 #include <unordered_map>
+#include "abilities.h"
 #include "types.h"
 #include "logger.h"
 
@@ -146,10 +147,14 @@ TypeAbilityComboList loadTypeAbilityCombos(const string& path) {
             combo.secondaryType = std::nullopt;
         }
 
-        combo.abilities.clear();
+        combo.abilities = AbilityList();
         if (entry.contains("abilities") && entry["abilities"].is_array()) {
             for (const auto& a : entry["abilities"]) {
-                if (a.is_string()) combo.abilities.push_back(a.get<string>());
+                if (!a.is_string()) continue;
+                if (combo.abilities.full()) {
+                    throw std::runtime_error("Too many abilities in type-ability combo: " + entry.dump());
+                }
+                combo.abilities.push_back(internAbility(a.get<string>()));
             }
         }
 
@@ -161,9 +166,10 @@ TypeAbilityComboList loadTypeAbilityCombos(const string& path) {
 
 double getTypeEffectiveness(
     const TypeEffectiveness& chart, 
+    const AbilityEffects& abilityEffects,
     const Type& attacker, 
     const Type& defender1,
-    const vector<string>& defenderAbilities,
+    const AbilityList& defenderAbilities,
     const std::optional<Type>& defender2
 ) {
     // Logger::debug("Calculating type effectiveness: attacker=" + typeToString(attacker) + ", defender1=" + typeToString(defender1) + (defender2 ? ", defender2=" + typeToString(*defender2) : "") );
@@ -173,40 +179,5 @@ double getTypeEffectiveness(
     }
 
     // This abilities section assumes the defender will use an ability that reduces effectiveness the most
-
-    // Evaluate potential immunities
-    for (const auto& ability : defenderAbilities) {
-        if (
-            (ability == "Levitate" && attacker == Type::Ground) ||
-            (ability == "Flash Fire" && attacker == Type::Fire) ||
-            (ability == "Water Absorb" && attacker == Type::Water) ||
-            ((
-                ability == "Volt Absorb" || 
-                ability == "Motor Drive" || 
-                ability == "Lightning Rod"
-            ) && attacker == Type::Electric) ||
-            (ability == "Dry Skin" && attacker == Type::Water) ||
-            (ability == "Wonder Guard" && effectiveness <= 1.0) ||
-            (ability == "Sap Sipper" && attacker == Type::Grass)
-        ) return 0.0;
-    }
-
-    // Evaluate other modifiers
-    for (const auto& ability : defenderAbilities) {
-        // Resistances
-        if (ability == "Thick Fat" && attacker == Type::Fire) return effectiveness * 0.5;
-        if (ability == "Thick Fat" && attacker == Type::Ice) return effectiveness * 0.5;
-        if (ability == "Heatproof" && attacker == Type::Fire) return effectiveness * 0.5;
-        if ((
-            ability == "Filter" ||
-            ability == "Solid Rock"
-        ) && effectiveness > 1.0) return effectiveness * 0.75;
-
-        // The rest
-        if (ability == "Dry Skin" && attacker == Type::Fire) return effectiveness * 1.25;
-        // todo: scrappy
-        // todo: mold breaker
-    }
-
-    return effectiveness;
+    return abilityEffects.apply(attacker, effectiveness, defenderAbilities);
 }
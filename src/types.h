@@ -1,9 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <initializer_list>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 // Enum for all Pokemon types
 enum class Type : uint8_t {
@@ -16,10 +20,39 @@ struct TypeUtils {
     static std::vector<Type> all();
 };
 
+// Interned ability name, see abilities.h
+using AbilityId = uint16_t;
+class AbilityEffects;
+
+// No Pokemon has more than three abilities; one spare slot for data that adds another
+constexpr size_t kMaxAbilities = 4;
+
+// Interned abilities of a Pokemon or target. Fixed capacity, so copying one never allocates.
+struct AbilityList {
+    std::array<AbilityId, kMaxAbilities> ids{};
+    uint8_t count = 0;
+
+    AbilityList() = default;
+    // Interns each name; throws std::invalid_argument for more than kMaxAbilities
+    AbilityList(std::initializer_list<std::string_view> names);
+
+    void push_back(AbilityId id) { ids[count++] = id; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == kMaxAbilities; }
+    AbilityId operator[](size_t i) const { return ids[i]; }
+    const AbilityId* begin() const { return ids.data(); }
+    const AbilityId* end() const { return ids.data() + count; }
+    bool operator==(const AbilityList& other) const {
+        return count == other.count && std::equal(begin(), end(), other.begin());
+    }
+    bool operator!=(const AbilityList& other) const { return !(*this == other); }
+};
+
 struct TypeAbilityCombo {
     Type primaryType;
     std::optional<Type> secondaryType;
-    std::vector<std::string> abilities;
+    AbilityList abilities;
 };
 using TypeAbilityComboList = std::vector<TypeAbilityCombo>;
 
@@ -40,8 +73,9 @@ TypeAbilityComboList loadTypeAbilityCombos(const std::string& path);
 
 double getTypeEffectiveness(
     const TypeEffectiveness& chart, 
+    const AbilityEffects& abilityEffects,
     const Type& attacker, 
     const Type& defender1,
-    const std::vector<std::string>& defenderAbilities,
+    const AbilityList& defenderAbilities,
     const std::optional<Type>& defender2 = std::nullopt
 );
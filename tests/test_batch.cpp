@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <vector>
+#include "batch.h"
+#include "abilities.h"
+#include "pokemon.h"
+#include "team.h"
+#include "types.h"
+
+using std::vector;
+
+TEST_CASE("BatchEvaluator") {
+    const TypeEffectiveness typeChart = loadTypeEffectiveness("typeChart.json");
+    const PokemonList pool = loadPokemon("coolPokemon.json");
+    const AbilityEffects abilityEffects = loadAbilityEffects("abilityEffects.json");
+    const TeamEvaluator evaluator(typeChart, abilityEffects);
+    const TypeAbilityComboList targets = loadTypeAbilityCombos("type_ability_combos.json");
+    const MemberProfileTable profiles = evaluator.buildProfiles(pool, targets);
+
+    // Teams of one to six members striding through the pool, repeats included
+    vector<TeamIndices> teams;
+    for (size_t i = 0; i < 200; ++i) {
+        TeamIndices team;
+        for (size_t slot = 0; slot <= i % kMaxTeamSize; ++slot) team.push_back((i * 7 + slot * 13) % pool.size());
+        teams.push_back(team);
+    }
+
+    vector<BatchKernel> kernels{ BatchKernel::Portable };
+    if (BatchEvaluator::bestKernel() != BatchKernel::Portable) kernels.push_back(BatchKernel::SSE2);
+    if (BatchEvaluator::bestKernel() == BatchKernel::AVX2) kernels.push_back(BatchKernel::AVX2);
+
+    SECTION("Every kernel matches the accumulated profiles") {
+        for (BatchKernel kernel : kernels) {
+            const BatchEvaluator batch(profiles, kernel);
+            REQUIRE(batch.kernel() == kernel);
+            vector<BatchScore> scores(teams.size());
+            batch.score(teams.data(), teams.size(), scores.data());
+
+            for (size_t i = 0; i < teams.size(); ++i) {
+                CoverageSet coverage(targets.size());
+                TeamDefense defense;
+                for (const size_t index : teams[i]) {
+                    coverage.merge(profiles[index].coverage);
+                    defense.add(profiles[index].defense);
+                }
+                REQUIRE(scores[i].offense == evaluator.evaluateOffense(coverage));
+                REQUIRE(scores[i].defense == evaluator.evaluateDefense(defense));
+            }
+        }
+    }
+    SECTION("Teams extend a shared base state from firstSlot on") {
+        CoverageSet baseCoverage(targets.size());
+        TeamDefense baseDefense;
+        for (const size_t index : {size_t{2}, size_t{5}}) {
+            baseCoverage.merge(profiles[index].coverage);
+            baseDefense.add(profiles[index].defense);
+        }
+        vector<TeamIndices> extended;
+        for (const auto& team : teams) {
+            if (team.size() > kMaxTeamSize - 2) continue;
+            TeamIndices withBase;
+            withBase.push_back(2);
+            withBase.push_back(5);
+            for (const size_t index : team) withBase.push_back(index);
+            extended.push_back(withBase);
+        }
+
+        for (BatchKernel kernel : kernels) {
+            const BatchEvaluator batch(profiles, kernel);
+            vector<BatchScore> fromBase(extended.size());
+            vector<BatchScore> fromScratch(extended.size());
+            batch.score(baseCoverage, baseDefense, extended.data(), extended.size(), 2, fromBase.data());
+            batch.score(extended.data(), extended.size(), fromScratch.data());
+            for (size_t i = 0; i < extended.size(); ++i) {
+                REQUIRE(fromBase[i].offense == fromScratch[i].offense);
+                REQUIRE(fromBase[i].defense == fromScratch[i].defense);
+            }
+        }
+    }
+    SECTION("Kernels the CPU lacks are rejected") {
+        if (BatchEvaluator::bestKernel() != BatchKernel::AVX2) {
+            REQUIRE_THROWS_AS(BatchEvaluator(profiles, BatchKernel::AVX2), std::invalid_argument);
+        }
+        REQUIRE_NOTHROW(BatchEvaluator(profiles, BatchEvaluator::bestKernel()));
+    }
+}
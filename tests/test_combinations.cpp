@@ -0,0 +1,199 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "combinations.h"
+
+using std::vector;
+
+TEST_CASE("binomialCoefficient") {
+    REQUIRE(binomialCoefficient(5, 0) == 1);
+    REQUIRE(binomialCoefficient(5, 5) == 1);
+    REQUIRE(binomialCoefficient(5, 2) == 10);
+    REQUIRE(binomialCoefficient(43, 4) == 123410);
+    REQUIRE(binomialCoefficient(3, 4) == 0);
+}
+
+TEST_CASE("CombinationEnumerator") {
+    SECTION("Walks every k-subset in lexicographic order") {
+        CombinationEnumerator combinations(5, 3);
+        vector<vector<size_t>> seen;
+        for (; !combinations.done(); combinations.next()) {
+            REQUIRE(combinations.rank() == seen.size());
+            seen.push_back(combinations.indices());
+        }
+        REQUIRE(seen.size() == 10);
+        REQUIRE(seen.front() == vector<size_t>{0, 1, 2});
+        REQUIRE(seen.back() == vector<size_t>{2, 3, 4});
+        REQUIRE(std::is_sorted(seen.begin(), seen.end()));
+        REQUIRE(std::adjacent_find(seen.begin(), seen.end()) == seen.end());
+    }
+    SECTION("Starting rank matches unrank and the full walk") {
+        CombinationEnumerator full(7, 4);
+        for (; !full.done(); full.next()) {
+            CombinationEnumerator fromRank(7, 4, full.rank());
+            REQUIRE(fromRank.indices() == full.indices());
+            REQUIRE(CombinationEnumerator::unrank(7, 4, full.rank()) == full.indices());
+        }
+    }
+    SECTION("Empty selection yields one combination") {
+        CombinationEnumerator combinations(4, 0);
+        REQUIRE_FALSE(combinations.done());
+        REQUIRE(combinations.indices().empty());
+        REQUIRE_FALSE(combinations.next());
+        REQUIRE(combinations.done());
+    }
+    SECTION("Out of range start is already done") {
+        CombinationEnumerator combinations(4, 2, 6);
+        REQUIRE(combinations.done());
+        CombinationEnumerator tooMany(2, 3);
+        REQUIRE(tooMany.done());
+        REQUIRE_THROWS_AS(CombinationEnumerator::unrank(4, 2, 6), std::out_of_range);
+    }
+}
+
+TEST_CASE("MultisetEnumerator") {
+    SECTION("Unit capacities reproduce CombinationEnumerator") {
+        MultisetCounter counter(vector<size_t>(7, 1), 4);
+        REQUIRE(counter.count(0, 4) == binomialCoefficient(7, 4));
+        MultisetEnumerator multisets(counter, 4);
+        CombinationEnumerator combinations(7, 4);
+        for (; !combinations.done(); combinations.next(), multisets.next()) {
+            REQUIRE_FALSE(multisets.done());
+            REQUIRE(multisets.rank() == combinations.rank());
+            REQUIRE(multisets.indices() == combinations.indices());
+        }
+        REQUIRE(multisets.done());
+    }
+    SECTION("Walks every bounded multiset in lexicographic order") {
+        // item 0 twice, item 1 never, item 2 three times, item 3 once
+        MultisetCounter counter({2, 0, 3, 1}, 3);
+        MultisetEnumerator multisets(counter, 3);
+        vector<vector<size_t>> seen;
+        for (; !multisets.done(); multisets.next()) {
+            REQUIRE(multisets.rank() == seen.size());
+            REQUIRE(multisets.unrank(multisets.rank()) == multisets.indices());
+            seen.push_back(multisets.indices());
+        }
+        const vector<vector<size_t>> expected{
+            {0, 0, 2}, {0, 0, 3}, {0, 2, 2}, {0, 2, 3}, {2, 2, 2}, {2, 2, 3}
+        };
+        REQUIRE(seen == expected);
+        REQUIRE(multisets.total() == expected.size());
+        REQUIRE_THROWS_AS(multisets.unrank(expected.size()), std::out_of_range);
+    }
+    SECTION("Restricted start item and starting rank") {
+        MultisetCounter counter({2, 2, 2}, 2);
+        // item 1 has one copy left: {1,2}, {2,2}
+        MultisetEnumerator tail(counter, 1, 1, 2);
+        REQUIRE(tail.total() == 2);
+        REQUIRE(tail.indices() == vector<size_t>{1, 2});
+        REQUIRE(tail.next());
+        REQUIRE(tail.indices() == vector<size_t>{2, 2});
+        REQUIRE_FALSE(tail.next());
+
+        MultisetEnumerator fromRank(counter, 2, 3);
+        REQUIRE(fromRank.indices() == vector<size_t>{1, 1});
+        MultisetEnumerator pastEnd(counter, 2, counter.count(0, 2));
+        REQUIRE(pastEnd.done());
+    }
+    SECTION("skip passes the rest of a prefix's subtree") {
+        MultisetCounter counter({2, 0, 3, 1, 2}, 4);
+        vector<vector<size_t>> all;
+        for (MultisetEnumerator walk(counter, 4); !walk.done(); walk.next()) all.push_back(walk.indices());
+
+        // Skip whenever the first two slots hold the same item; compare with filtering the full walk
+        vector<vector<size_t>> expected;
+        for (const auto& indices : all) {
+            if (indices[0] != indices[1]) expected.push_back(indices);
+        }
+        vector<vector<size_t>> seen;
+        size_t visited = 0;
+        MultisetEnumerator multisets(counter, 4);
+        while (!multisets.done()) {
+            REQUIRE(multisets.indices() == all[multisets.rank()]);
+            if (multisets.indices()[0] == multisets.indices()[1]) {
+                const vector<size_t> prefix(multisets.indices().begin(), multisets.indices().begin() + 2);
+                const size_t skipped = multisets.skip(1);
+                visited += skipped;
+                REQUIRE(skipped == static_cast<size_t>(std::count_if(all.begin(), all.end(), [&](const vector<size_t>& indices) {
+                    return indices[0] == prefix[0] && indices[1] == prefix[1];
+                })));
+                if (!multisets.done()) REQUIRE(multisets.changedSlot() <= 1);
+                continue;
+            }
+            seen.push_back(multisets.indices());
+            ++visited;
+            multisets.next();
+        }
+        REQUIRE(seen == expected);
+        REQUIRE(visited == all.size());
+    }
+    SECTION("Budgets restrict the walk to multisets within them") {
+        // Resource 0 is spent by items 1 and 3, resource 1 by items 2 and 3
+        const vector<size_t> capacities{2, 2, 2, 1, 3};
+        const vector<MultisetCounter::Resources> costs{{0, 0}, {1, 0}, {0, 1}, {1, 1}, {0, 0}};
+        const MultisetCounter::Resources budget{2, 1};
+        const MultisetCounter free(capacities, 4);
+        const MultisetCounter counter(capacities, 4, costs, budget);
+        auto within = [&](const vector<size_t>& indices, const MultisetCounter::Resources& limit) {
+            MultisetCounter::Resources spent{};
+            for (const size_t index : indices) {
+                for (size_t r = 0; r < spent.size(); ++r) spent[r] += costs[index][r];
+            }
+            return spent[0] <= limit[0] && spent[1] <= limit[1];
+        };
+
+        vector<vector<size_t>> expected;
+        for (MultisetEnumerator walk(free, 4); !walk.done(); walk.next()) {
+            if (within(walk.indices(), budget)) expected.push_back(walk.indices());
+        }
+        REQUIRE(counter.count(0, 4) == expected.size());
+
+        vector<vector<size_t>> seen;
+        MultisetEnumerator multisets(counter, 4);
+        for (; !multisets.done(); multisets.next()) {
+            REQUIRE(multisets.rank() == seen.size());
+            REQUIRE(multisets.unrank(multisets.rank()) == multisets.indices());
+            seen.push_back(multisets.indices());
+        }
+        REQUIRE(seen == expected);
+        REQUIRE(multisets.total() == expected.size());
+
+        // A tail after a prefix that spent some of the budget, starting mid-walk
+        const MultisetCounter::Resources left{1, 0};
+        vector<vector<size_t>> tail;
+        for (MultisetEnumerator walk(free, 1, 1, 3); !walk.done(); walk.next()) {
+            if (within(walk.indices(), left)) tail.push_back(walk.indices());
+        }
+        MultisetEnumerator fromRank(counter, 1, 1, 3, left, 2);
+        REQUIRE(fromRank.total() == tail.size());
+        for (size_t rank = 2; rank < tail.size(); ++rank, fromRank.next()) {
+            REQUIRE(fromRank.indices() == tail[rank]);
+        }
+        REQUIRE(fromRank.done());
+
+        REQUIRE(counter.firstItem(0, 2, 4, MultisetCounter::Resources{0, 0}) == 0);
+        REQUIRE(counter.firstItem(1, 2, 1, MultisetCounter::Resources{0, 0}) == 4);
+        REQUIRE(counter.firstItem(4, 3, 4, budget) == counter.itemCount());
+        REQUIRE_THROWS_AS(MultisetCounter(capacities, 4, vector<MultisetCounter::Resources>(2), budget), std::invalid_argument);
+    }
+    SECTION("changedSlot marks the first rewritten slot") {
+        MultisetCounter counter({2, 0, 3, 1, 2}, 4);
+        MultisetEnumerator multisets(counter, 4);
+        CombinationEnumerator combinations(6, 3);
+        REQUIRE(multisets.changedSlot() == 0);
+        REQUIRE(combinations.changedSlot() == 0);
+        auto requireChangedFrom = [](const vector<size_t>& before, const vector<size_t>& after, size_t slot) {
+            REQUIRE(slot < after.size());
+            REQUIRE(std::equal(before.begin(), before.begin() + slot, after.begin()));
+            REQUIRE(before[slot] != after[slot]);
+        };
+        for (vector<size_t> before = multisets.indices(); multisets.next(); before = multisets.indices()) {
+            requireChangedFrom(before, multisets.indices(), multisets.changedSlot());
+        }
+        for (vector<size_t> before = combinations.indices(); combinations.next(); before = combinations.indices()) {
+            requireChangedFrom(before, combinations.indices(), combinations.changedSlot());
+        }
+    }
+}
@@ -0,0 +1,450 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "generator.h"
+#include "pokemon.h"
+#include "abilities.h"
+#include "intern.h"
+#include "team.h"
+#include "types.h"
+
+using std::vector;
+
+namespace {
+    void requireSameResults(const vector<ScoredTeam>& a, const vector<ScoredTeam>& b) {
+        REQUIRE(a.size() == b.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            REQUIRE(a[i].offensiveScore == b[i].offensiveScore);
+            REQUIRE(a[i].defensiveScore == b[i].defensiveScore);
+            REQUIRE(a[i].team.size() == b[i].team.size());
+            for (size_t m = 0; m < a[i].team.size(); ++m) {
+                REQUIRE(a[i].team[m].name == b[i].team[m].name);
+            }
+        }
+    }
+}
+
+TEST_CASE("generateTopTeams") {
+    const TypeEffectiveness typeChart = loadTypeEffectiveness("typeChart.json");
+    const PokemonList pool = loadPokemon("coolPokemon.json");
+    const AbilityEffects abilityEffects = loadAbilityEffects("abilityEffects.json");
+    const TypeAbilityComboList targets = loadTypeAbilityCombos("type_ability_combos.json");
+    const TeamEvaluator evaluator(typeChart, abilityEffects, targets);
+
+    SECTION("Results are sorted best first and materialized") {
+        TeamGenerator generator(pool, evaluator, ConflictRule::NoRule);
+        vector<ScoredTeam> teams = generator.generateTopTeams(3, 10);
+        REQUIRE(teams.size() == 10);
+        for (size_t i = 0; i < teams.size(); ++i) {
+            REQUIRE(teams[i].team.size() == 3);
+            REQUIRE(teams[i].defensiveScore >= 0.0);
+            REQUIRE(teams[i].offensiveScore == evaluator.evaluateOffense(teams[i].team, targets));
+            REQUIRE(teams[i].defensiveScore == evaluator.evaluateDefense(teams[i].team, TypeUtils::all()));
+            if (i > 0) {
+                REQUIRE(StandardRanking::combine(teams[i - 1].offensiveScore, teams[i - 1].defensiveScore) >=
+                    StandardRanking::combine(teams[i].offensiveScore, teams[i].defensiveScore));
+            }
+        }
+    }
+    SECTION("Teams are scored against the evaluator's targets") {
+        // One warm evaluator answers repeated queries; another scores a subset of the targets
+        TeamGenerator generator(pool, evaluator, ConflictRule::NoRule);
+        requireSameResults(generator.generateTopTeams(3, 5), generator.generateTopTeams(3, 5));
+
+        const TypeAbilityComboList fewer(targets.begin(), targets.begin() + targets.size() / 3);
+        const TeamEvaluator fewerEvaluator(typeChart, abilityEffects, fewer);
+        TeamGenerator fewerGenerator(pool, fewerEvaluator, ConflictRule::NoRule);
+        const vector<ScoredTeam> teams = fewerGenerator.generateTopTeams(3, 5);
+        REQUIRE(teams.size() == 5);
+        for (const auto& scored : teams) {
+            REQUIRE(scored.offensiveScore == evaluator.evaluateOffense(scored.team, fewer));
+        }
+    }
+    SECTION("Pinned members are kept in every team") {
+        const PokemonList pinned{ pool[0], pool[1] };
+        TeamGenerator generator(pool, evaluator, ConflictRule::NoRule);
+        vector<ScoredTeam> teams = generator.generateTopTeams(4, 5, pinned);
+        REQUIRE(teams.size() == 5);
+        for (const auto& scored : teams) {
+            REQUIRE(scored.team[0].name == pool[0].name);
+            REQUIRE(scored.team[1].name == pool[1].name);
+        }
+    }
+    SECTION("Pinned members count toward the conflict rule") {
+        auto isGhost = [](const Pokemon& p) {
+            return p.primaryType == Type::Ghost || (p.secondaryType && *p.secondaryType == Type::Ghost);
+        };
+        PokemonList nonGhosts;
+        for (const auto& p : pool) {
+            if (!isGhost(p)) nonGhosts.push_back(p);
+        }
+        REQUIRE(nonGhosts.size() >= 3);
+
+        TeamGenerator generator(pool, evaluator, ConflictRule::TGOM_Ghost);
+        const vector<ScoredTeam> teams = generator.generateTopTeams(4, 10, PokemonList{ nonGhosts[0] });
+        REQUIRE_FALSE(teams.empty());
+        for (const auto& scored : teams) {
+            REQUIRE(std::count_if(scored.team.begin(), scored.team.end(), [&](const Pokemon& p) { return !isGhost(p); }) <= 2);
+        }
+        // Pins that already break the rule leave nothing to build
+        REQUIRE(generator.generateTopTeams(4, 10, PokemonList(nonGhosts.begin(), nonGhosts.begin() + 3)).empty());
+    }
+    SECTION("Composed rules enforce every rule") {
+        const ConflictRule both = ConflictRule::TGOM_Ghost | ConflictRule::NoTypeOverlap;
+        REQUIRE(hasRule(both, ConflictRule::TGOM_Ghost));
+        REQUIRE(hasRule(both, ConflictRule::NoTypeOverlap));
+        REQUIRE_FALSE(hasRule(ConflictRule::TGOM_Ghost, both));
+
+        // Ghosts share a type, so a team holds one ghost and two non-ghosts at most
+        TeamGenerator serial(pool, evaluator, both);
+        const vector<ScoredTeam> expected = serial.generateTopTeams(3, 10);
+        REQUIRE(serial.generateTopTeams(4, 10).empty());
+        REQUIRE_FALSE(expected.empty());
+        for (const auto& scored : expected) {
+            size_t nonGhosts = 0;
+            vector<Type> types;
+            for (const auto& member : scored.team) {
+                const bool ghost = member.primaryType == Type::Ghost || (member.secondaryType && *member.secondaryType == Type::Ghost);
+                if (!ghost) ++nonGhosts;
+                types.push_back(member.primaryType);
+                if (member.secondaryType) types.push_back(*member.secondaryType);
+            }
+            REQUIRE(nonGhosts <= 2);
+            std::sort(types.begin(), types.end());
+            REQUIRE(std::adjacent_find(types.begin(), types.end()) == types.end());
+        }
+        for (ConflictRule single : {ConflictRule::TGOM_Ghost, ConflictRule::NoTypeOverlap}) {
+            TeamGenerator looser(pool, evaluator, single);
+            const ScoredTeam best = looser.generateTopTeams(3, 1).front();
+            REQUIRE(StandardRanking::combine(best.offensiveScore, best.defensiveScore) >=
+                StandardRanking::combine(expected.front().offensiveScore, expected.front().defensiveScore));
+        }
+
+        for (SearchStrategy strategy : {SearchStrategy::Exhaustive, SearchStrategy::BranchAndBound}) {
+            GeneratorOptions options;
+            options.strategy = strategy;
+            options.backend = ExecutionBackend::WorkStealing;
+            options.threadCount = 2;
+            TeamGenerator stealing(pool, evaluator, both, options);
+            requireSameResults(stealing.generateTopTeams(3, 10), expected);
+        }
+    }
+    SECTION("Parallel search matches the serial search") {
+        const PokemonList pinned{ pool[3] };
+        TeamGenerator serial(pool, evaluator, ConflictRule::TGOM_Ghost);
+        const vector<ScoredTeam> expected = serial.generateTopTeams(4, 10, pinned);
+
+        for (size_t threads : {2, 3, 7}) {
+            GeneratorOptions options;
+            options.threadCount = threads;
+            TeamGenerator parallel(pool, evaluator, ConflictRule::TGOM_Ghost, options);
+            requireSameResults(parallel.generateTopTeams(4, 10, pinned), expected);
+        }
+    }
+    SECTION("Branch and bound matches the exhaustive search") {
+        for (ConflictRule rule : {ConflictRule::NoRule, ConflictRule::NoTypeOverlap, ConflictRule::TGOM_Ghost}) {
+            TeamGenerator exhaustive(pool, evaluator, rule);
+            const vector<ScoredTeam> expected = exhaustive.generateTopTeams(4, 10, { pool[3] });
+
+            for (size_t threads : {1, 3}) {
+                GeneratorOptions options;
+                options.strategy = SearchStrategy::BranchAndBound;
+                options.threadCount = threads;
+                TeamGenerator pruned(pool, evaluator, rule, options);
+                requireSameResults(pruned.generateTopTeams(4, 10, { pool[3] }), expected);
+                // Thousands of teams for ten places: some subtrees must fall below the tenth best
+                REQUIRE(pruned.prunedTeams() > 0);
+            }
+        }
+
+        TeamGenerator exhaustive(pool, evaluator, ConflictRule::NoRule);
+        exhaustive.generateTopTeams(4, 10, { pool[3] });
+        REQUIRE(exhaustive.prunedTeams() == 0);
+    }
+    SECTION("Collapsing equivalent members reports the same teams") {
+        // Renamed copies share every class with their originals, so many teams tie
+        PokemonList twins = pool;
+        for (size_t i = 0; i < 12; ++i) {
+            Pokemon twin = pool[i];
+            twin.name = internName(string(twin.name) + "-twin");
+            twins.push_back(twin);
+        }
+        const PokemonList pinned{ twins[5] };
+        for (ConflictRule rule : {ConflictRule::NoRule, ConflictRule::NoTypeOverlap, ConflictRule::TGOM_Ghost,
+                                  ConflictRule::TGOM_Ghost | ConflictRule::NoTypeOverlap}) {
+            TeamGenerator named(twins, evaluator, rule);
+            const vector<ScoredTeam> expected = named.generateTopTeams(4, 25, pinned);
+
+            for (SearchStrategy strategy : {SearchStrategy::Exhaustive, SearchStrategy::BranchAndBound}) {
+                for (ExecutionBackend backend : {ExecutionBackend::StaticRanges, ExecutionBackend::WorkStealing}) {
+                    GeneratorOptions options;
+                    options.collapseEquivalentMembers = true;
+                    options.strategy = strategy;
+                    options.backend = backend;
+                    options.threadCount = 3;
+                    TeamGenerator collapsed(twins, evaluator, rule, options);
+                    requireSameResults(collapsed.generateTopTeams(4, 25, pinned), expected);
+                }
+            }
+        }
+    }
+    SECTION("Dominance pruning keeps the top-N scores") {
+        // Four copies of a member: the first-named copy is dominated by the other three
+        PokemonList copies = pool;
+        for (size_t i = 0; i < 10; ++i) {
+            for (const char* suffix : {"-b", "-c", "-d"}) {
+                Pokemon copy = pool[i];
+                copy.name = internName(string(copy.name) + suffix);
+                copies.push_back(copy);
+            }
+        }
+        for (ConflictRule rule : {ConflictRule::NoRule, ConflictRule::NoTypeOverlap, ConflictRule::TGOM_Ghost}) {
+            for (size_t topN : {1, 8}) {
+                TeamGenerator full(copies, evaluator, rule);
+                const vector<ScoredTeam> expected = full.generateTopTeams(3, topN);
+
+                GeneratorOptions options;
+                options.pruneDominatedMembers = true;
+                TeamGenerator pruned(copies, evaluator, rule, options);
+                const vector<ScoredTeam> teams = pruned.generateTopTeams(3, topN);
+                if (topN == 1) REQUIRE(pruned.dominatedMembersRemoved() >= 10);
+                REQUIRE(teams.size() == expected.size());
+                for (size_t i = 0; i < teams.size(); ++i) {
+                    REQUIRE(teams[i].offensiveScore == expected[i].offensiveScore);
+                    REQUIRE(teams[i].defensiveScore == expected[i].defensiveScore);
+                }
+            }
+        }
+    }
+    SECTION("Every ranking policy orders the results and bounds the search") {
+        for (const RankingPolicy ranking : {StandardRanking::policy, BalancedRanking::policy, OffenseRanking::policy, RankingPolicy{2.0, 3.0}}) {
+            GeneratorOptions options;
+            options.ranking = ranking;
+            TeamGenerator exhaustive(pool, evaluator, ConflictRule::TGOM_Ghost, options);
+            const vector<ScoredTeam> expected = exhaustive.generateTopTeams(4, 10);
+            REQUIRE(expected.size() == 10);
+            for (size_t i = 1; i < expected.size(); ++i) {
+                REQUIRE(ranking.combine(expected[i - 1].offensiveScore, expected[i - 1].defensiveScore) >=
+                    ranking.combine(expected[i].offensiveScore, expected[i].defensiveScore));
+            }
+
+            options.strategy = SearchStrategy::BranchAndBound;
+            options.threadCount = 3;
+            TeamGenerator pruned(pool, evaluator, ConflictRule::TGOM_Ghost, options);
+            requireSameResults(pruned.generateTopTeams(4, 10), expected);
+        }
+
+        // Weights without an exact binary value round the bound's partial sums differently from
+        // the team's own score, so a bound that only ties the N-th best can land an ulp below it
+        for (const RankingPolicy ranking : {RankingPolicy{0.1, 0.3}, RankingPolicy{0.1, 0.7}, RankingPolicy{0.3, 0.1}}) {
+            for (size_t topN : {1, 3, 5}) {
+                GeneratorOptions options;
+                options.ranking = ranking;
+                TeamGenerator exhaustive(pool, evaluator, ConflictRule::NoRule, options);
+                const vector<ScoredTeam> expected = exhaustive.generateTopTeams(3, topN);
+
+                options.strategy = SearchStrategy::BranchAndBound;
+                TeamGenerator pruned(pool, evaluator, ConflictRule::NoRule, options);
+                requireSameResults(pruned.generateTopTeams(3, topN), expected);
+            }
+        }
+
+        GeneratorOptions negative;
+        negative.ranking = RankingPolicy{1.0, -4.0};
+        TeamGenerator rejected(pool, evaluator, ConflictRule::TGOM_Ghost, negative);
+        REQUIRE(rejected.generateTopTeams(4, 10).empty());
+    }
+    SECTION("The Pareto frontier holds every weighting's best team") {
+        // Every valid team, to find the frontier by brute force
+        TeamGenerator everything(pool, evaluator, ConflictRule::TGOM_Ghost);
+        const vector<ScoredTeam> all = everything.generateTopTeams(3, 100000);
+        vector<ScoredTeam> expected;
+        for (const auto& team : all) {
+            const bool beaten = std::any_of(all.begin(), all.end(), [&team](const ScoredTeam& other) {
+                return other.offensiveScore >= team.offensiveScore && other.defensiveScore >= team.defensiveScore &&
+                    (other.offensiveScore > team.offensiveScore || other.defensiveScore > team.defensiveScore);
+            });
+            const bool tieLost = std::any_of(all.begin(), all.end(), [&team](const ScoredTeam& other) {
+                return other.offensiveScore == team.offensiveScore && other.defensiveScore == team.defensiveScore &&
+                    team.members < other.members;
+            });
+            if (!beaten && !tieLost) expected.push_back(team);
+        }
+        std::sort(expected.begin(), expected.end(), [](const ScoredTeam& a, const ScoredTeam& b) {
+            return a.offensiveScore > b.offensiveScore;
+        });
+        REQUIRE(expected.size() > 1);
+
+        for (const SearchStrategy strategy : {SearchStrategy::Exhaustive, SearchStrategy::BranchAndBound}) {
+            for (const bool collapse : {false, true}) {
+                GeneratorOptions options;
+                options.strategy = strategy;
+                options.collapseEquivalentMembers = collapse;
+                options.threadCount = 3;
+                TeamGenerator generator(pool, evaluator, ConflictRule::TGOM_Ghost, options);
+                const vector<ScoredTeam> frontier = generator.generateParetoFrontier(3);
+                requireSameResults(frontier, expected);
+
+                for (const RankingPolicy ranking : {StandardRanking::policy, OffenseRanking::policy, RankingPolicy{0.5, 7.0}}) {
+                    GeneratorOptions ranked = options;
+                    ranked.ranking = ranking;
+                    TeamGenerator best(pool, evaluator, ConflictRule::TGOM_Ghost, ranked);
+                    requireSameResults({ rankFrontier(frontier, ranking).front() }, best.generateTopTeams(3, 1));
+                }
+            }
+        }
+    }
+    SECTION("Heuristic search finds top teams within its budget") {
+        TeamGenerator exhaustive(pool, evaluator, ConflictRule::TGOM_Ghost);
+        const vector<ScoredTeam> expected = exhaustive.generateTopTeams(4, 10, { pool[3] });
+
+        GeneratorOptions options;
+        options.strategy = SearchStrategy::Heuristic;
+        options.threadCount = 2;
+        options.heuristic.evaluationBudget = 200000;
+        TeamGenerator heuristic(pool, evaluator, ConflictRule::TGOM_Ghost, options);
+        const vector<ScoredTeam> teams = heuristic.generateTopTeams(4, 10, { pool[3] });
+        REQUIRE(teams.size() == expected.size());
+        for (size_t i = 0; i < teams.size(); ++i) {
+            // Never better than the true i-th best, and distinct, valid teams
+            REQUIRE(StandardRanking::combine(teams[i].offensiveScore, teams[i].defensiveScore) <=
+                StandardRanking::combine(expected[i].offensiveScore, expected[i].defensiveScore));
+            REQUIRE(teams[i].offensiveScore == evaluator.evaluateOffense(teams[i].team, targets));
+            REQUIRE(teams[i].defensiveScore == evaluator.evaluateDefense(teams[i].team, TypeUtils::all()));
+            REQUIRE(teams[i].team.front().name == pool[3].name);
+            for (size_t j = 0; j < i; ++j) REQUIRE((teams[j].members < teams[i].members || teams[i].members < teams[j].members));
+        }
+        REQUIRE(teams.front().offensiveScore == expected.front().offensiveScore);
+        REQUIRE(teams.front().defensiveScore == expected.front().defensiveScore);
+
+        const HeuristicStats& stats = heuristic.heuristicStats();
+        REQUIRE(stats.evaluations == options.heuristic.evaluationBudget);
+        REQUIRE(stats.bestScore == StandardRanking::combine(expected.front().offensiveScore, expected.front().defensiveScore));
+        REQUIRE(stats.upperBound >= stats.bestScore);
+        REQUIRE(stats.gap() >= 0.0);
+
+        // An evaluation budget alone makes runs repeatable
+        TeamGenerator again(pool, evaluator, ConflictRule::TGOM_Ghost, options);
+        requireSameResults(again.generateTopTeams(4, 10, { pool[3] }), teams);
+    }
+    SECTION("Heuristic search ends when no swap is valid") {
+        // Every swap of a pool that exactly fills the team brings in a member it already holds
+        const PokemonList small(pool.begin(), pool.begin() + 4);
+        GeneratorOptions options;
+        options.strategy = SearchStrategy::Heuristic;
+        options.heuristic.evaluationBudget = 1000;
+        options.heuristic.timeBudget = std::chrono::milliseconds(200);
+        TeamGenerator heuristic(small, evaluator, ConflictRule::NoRule, options);
+        const vector<ScoredTeam> teams = heuristic.generateTopTeams(4, 5);
+        TeamGenerator exhaustive(small, evaluator, ConflictRule::NoRule);
+        requireSameResults(teams, exhaustive.generateTopTeams(4, 5));
+        REQUIRE(heuristic.heuristicStats().evaluations == options.heuristic.evaluationBudget);
+    }
+    SECTION("Heuristic search stops at its time budget") {
+        GeneratorOptions options;
+        options.strategy = SearchStrategy::Heuristic;
+        options.heuristic.evaluationBudget = 0;
+        options.heuristic.timeBudget = std::chrono::milliseconds(50);
+        TeamGenerator heuristic(pool, evaluator, ConflictRule::NoRule, options);
+        const auto start = std::chrono::steady_clock::now();
+        REQUIRE(heuristic.generateTopTeams(6, 10).size() == 10);
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+
+        options.heuristic.timeBudget = std::chrono::milliseconds(0);
+        TeamGenerator unbounded(pool, evaluator, ConflictRule::NoRule, options);
+        REQUIRE(unbounded.generateTopTeams(6, 10).empty());
+    }
+    SECTION("A passed deadline stops every strategy early") {
+        for (const SearchStrategy strategy : {SearchStrategy::Exhaustive, SearchStrategy::BranchAndBound, SearchStrategy::Heuristic}) {
+            GeneratorOptions options;
+            options.strategy = strategy;
+            options.threadCount = 2;
+            options.deadline = std::chrono::steady_clock::now();
+            TeamGenerator generator(pool, evaluator, ConflictRule::NoRule, options);
+            REQUIRE(generator.generateTopTeams(5, 10).size() <= 10);
+            REQUIRE(generator.stoppedEarly());
+            if (strategy != SearchStrategy::Heuristic) {
+                generator.generateParetoFrontier(5);
+                REQUIRE(generator.stoppedEarly());
+            }
+        }
+        TeamGenerator unhurried(pool, evaluator, ConflictRule::NoRule);
+        unhurried.generateTopTeams(3, 10);
+        REQUIRE_FALSE(unhurried.stoppedEarly());
+    }
+    SECTION("Snapshots report the best teams so far and cancellation keeps them") {
+        TeamGenerator complete(pool, evaluator, ConflictRule::NoRule);
+        const vector<ScoredTeam> expected = complete.generateTopTeams(5, 10);
+
+        CancellationToken token;
+        vector<vector<ScoredTeam>> snapshots;
+        GeneratorOptions options;
+        options.cancellation = &token;
+        options.snapshotInterval = std::chrono::milliseconds(0);
+        options.onSnapshot = [&](const vector<ScoredTeam>& teams) {
+            snapshots.push_back(teams);
+            token.cancel();
+        };
+        TeamGenerator generator(pool, evaluator, ConflictRule::NoRule, options);
+        const vector<ScoredTeam> teams = generator.generateTopTeams(5, 10);
+        REQUIRE(generator.stoppedEarly());
+        REQUIRE(snapshots.size() == 1);
+        REQUIRE(!snapshots.front().empty());
+        REQUIRE(snapshots.front().front().team.size() == 5);
+
+        auto combined = [](const ScoredTeam& team) { return StandardRanking::combine(team.offensiveScore, team.defensiveScore); };
+        REQUIRE(teams.size() == 10);
+        REQUIRE(combined(teams.front()) >= combined(snapshots.front().front()));
+        for (size_t i = 0; i < teams.size(); ++i) {
+            REQUIRE(combined(teams[i]) <= combined(expected[i]));
+            REQUIRE(teams[i].offensiveScore == evaluator.evaluateOffense(teams[i].team, targets));
+        }
+    }
+    SECTION("Work-stealing backend matches the serial search") {
+        const PokemonList pinned{ pool[3] };
+        TeamGenerator serial(pool, evaluator, ConflictRule::TGOM_Ghost);
+        const vector<ScoredTeam> expected = serial.generateTopTeams(4, 10, pinned);
+
+        for (size_t threads : {1, 4}) {
+            for (size_t splitDepth : {0, 1, 3}) {
+                GeneratorOptions options;
+                options.threadCount = threads;
+                options.backend = ExecutionBackend::WorkStealing;
+                options.splitDepth = splitDepth;
+                TeamGenerator stealing(pool, evaluator, ConflictRule::TGOM_Ghost, options);
+                requireSameResults(stealing.generateTopTeams(4, 10, pinned), expected);
+                REQUIRE(stealing.schedulerStats().workers.size() == threads);
+                REQUIRE(stealing.schedulerStats().totalTasks() > 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("scoreAndFilterTeams") {
+    const TypeEffectiveness typeChart = loadTypeEffectiveness("typeChart.json");
+    const PokemonList pool = loadPokemon("coolPokemon.json");
+    const AbilityEffects abilityEffects = loadAbilityEffects("abilityEffects.json");
+    const TeamEvaluator evaluator(typeChart, abilityEffects);
+    const TypeAbilityComboList targets = loadTypeAbilityCombos("type_ability_combos.json");
+
+    SECTION("Batch scores match the scalar evaluators") {
+        // Repeated members, a renamed duplicate with other types, and a team too large for TeamIndices
+        vector<Team> teams;
+        for (size_t i = 0; i + 3 <= pool.size(); ++i) teams.push_back(Team{ pool[i], pool[i + 1], pool[(i * 5) % pool.size()] });
+        Pokemon impostor = pool[0];
+        impostor.primaryType = Type::Steel;
+        teams.push_back(Team{ pool[0], impostor });
+        teams.push_back(Team(pool.begin(), pool.begin() + kMaxTeamSize + 1));
+
+        TeamGenerator generator(pool, evaluator, ConflictRule::NoRule);
+        const vector<ScoredTeam> scored = generator.scoreAndFilterTeams(teams, targets);
+        vector<ScoredTeam> expected;
+        for (const auto& team : teams) {
+            const double defense = evaluator.evaluateDefense(team, TypeUtils::all());
+            if (defense >= 0.0) expected.push_back(ScoredTeam{team, evaluator.evaluateOffense(team, targets), defense, {}});
+        }
+        REQUIRE(!expected.empty());
+        requireSameResults(scored, expected);
+    }
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "abilities.h"
+#include "intern.h"
+#include "pokemon.h"
+
+TEST_CASE("StringPool") {
+    SECTION("Equal strings share one ID and one copy") {
+        StringPool pool;
+        std::string text = "Garchomp";
+        const StringPool::Id id = pool.intern(text);
+        REQUIRE(pool.intern("Garchomp") == id);
+        REQUIRE(pool.intern("garchomp") != id);
+        REQUIRE(pool.size() == 2);
+
+        // The view is the pool's own copy, not the caller's string
+        const std::string_view view = pool.view(id);
+        text = "Overwritten";
+        REQUIRE(view == "Garchomp");
+        REQUIRE(pool.view(pool.intern("Garchomp")).data() == view.data());
+        REQUIRE(pool.view(99).empty());
+    }
+    SECTION("Views stay valid as the arena grows") {
+        StringPool pool;
+        std::vector<std::string_view> views;
+        for (size_t i = 0; i < 2000; ++i) views.push_back(pool.view(pool.intern("member-" + std::to_string(i))));
+        const std::string longName(10000, 'x');
+        const std::string_view longView = pool.view(pool.intern(longName));
+        for (size_t i = 0; i < 2000; ++i) pool.intern("more-" + std::to_string(i));
+
+        for (size_t i = 0; i < views.size(); ++i) REQUIRE(views[i] == "member-" + std::to_string(i));
+        REQUIRE(longView == longName);
+        REQUIRE(pool.arenaBytes() >= pool.size() * 6 + longName.size());
+    }
+    SECTION("Concurrent interning agrees on IDs") {
+        StringPool pool;
+        std::vector<std::vector<StringPool::Id>> ids(4);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < ids.size(); ++t) {
+            threads.emplace_back([&pool, &ids, t] {
+                for (size_t i = 0; i < 500; ++i) ids[t].push_back(pool.intern("name-" + std::to_string(i)));
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        REQUIRE(pool.size() == 500);
+        for (const auto& run : ids) REQUIRE(run == ids[0]);
+    }
+    SECTION("Interned names are process-wide") {
+        const std::string name = "Rotom-W";
+        REQUIRE(internName(name).data() == internName("Rotom-W").data());
+        REQUIRE(internName(name) == "Rotom-W");
+    }
+}
+
+TEST_CASE("AbilityList") {
+    SECTION("Holds interned abilities inline") {
+        const AbilityList abilities{"Levitate", "Thick Fat"};
+        REQUIRE(abilities.size() == 2);
+        REQUIRE(abilities[0] == internAbility("Levitate"));
+        REQUIRE(abilityName(abilities[1]) == "Thick Fat");
+        REQUIRE(abilities == internAbilities({"Levitate", "Thick Fat"}));
+        REQUIRE(abilities != AbilityList{"Thick Fat", "Levitate"});
+        REQUIRE(AbilityList{}.empty());
+        REQUIRE(std::is_trivially_copyable<AbilityList>::value);
+        REQUIRE(std::is_trivially_copyable<Pokemon>::value);
+    }
+    SECTION("More than kMaxAbilities is rejected") {
+        REQUIRE_THROWS_AS((AbilityList{"A", "B", "C", "D", "E"}), std::invalid_argument);
+        REQUIRE_THROWS_AS(internAbilities({"A", "B", "C", "D", "E"}), std::invalid_argument);
+        REQUIRE(AbilityList{"A", "B", "C", "D"}.full());
+    }
+}
@@ -1,9 +1,23 @@
 #include <catch2/catch_test_macros.hpp>
 #include <fstream>
+#include <stdexcept>
+#include "abilities.h"
 #include "pokemon.h"
 
 using std::string;
 
+namespace {
+    // Message of the error loadPokemon throws for a file, or empty if it loads
+    string loadError(const string& fileName) {
+        try {
+            loadPokemon(fileName);
+        } catch (const std::runtime_error& ex) {
+            return ex.what();
+        }
+        return {};
+    }
+}
+
 TEST_CASE("loadPokemon") {
     SECTION("valid data") {
         const string fileName = "test_pokemon_valid.json";
@@ -45,38 +59,47 @@ TEST_CASE("loadPokemon") {
         REQUIRE(list[0].secondaryType.has_value());
         REQUIRE(list[0].secondaryType.value() == Type::Poison);
         REQUIRE(list[0].abilities.size() == 2);
-        REQUIRE(list[0].abilities[0] == "Overgrow");
-        REQUIRE(list[0].abilities[1] == "Chlorophyll");
+        REQUIRE(abilityName(list[0].abilities[0]) == "Overgrow");
+        REQUIRE(abilityName(list[0].abilities[1]) == "Chlorophyll");
 
         REQUIRE(list[1].name == "Charmander");
         REQUIRE(list[1].primaryType == Type::Fire);
         REQUIRE(!list[1].secondaryType.has_value());
         REQUIRE(list[1].abilities.size() == 2);
-        REQUIRE(list[1].abilities[0] == "Blaze");
-        REQUIRE(list[1].abilities[1] == "Solar Power");
+        REQUIRE(abilityName(list[1].abilities[0]) == "Blaze");
+        REQUIRE(abilityName(list[1].abilities[1]) == "Solar Power");
 
         REQUIRE(list[2].name == "Mamoswine");
         REQUIRE(list[2].primaryType == Type::Ground);
         REQUIRE(list[2].secondaryType.has_value());
         REQUIRE(list[2].secondaryType.value() == Type::Ice);
         REQUIRE(list[2].abilities.size() == 2);
-        REQUIRE(list[2].abilities[0] == "Snow Cloak");
-        REQUIRE(list[2].abilities[1] == "Thick Fat");
+        REQUIRE(abilityName(list[2].abilities[0]) == "Snow Cloak");
+        REQUIRE(abilityName(list[2].abilities[1]) == "Thick Fat");
 
         REQUIRE(list[3].name == "Mismagius");
         REQUIRE(list[3].primaryType == Type::Ghost);
         REQUIRE(list[3].secondaryType.has_value());
         REQUIRE(list[3].secondaryType.value() == Type::Fairy);
         REQUIRE(list[3].abilities.size() == 1);
-        REQUIRE(list[3].abilities[0] == "Levitate");
+        REQUIRE(abilityName(list[3].abilities[0]) == "Levitate");
+
+        // Names and abilities are interned while loading
+        REQUIRE(list[2].abilities[1] == internAbility("Thick Fat"));
+        REQUIRE(list[3].abilities == AbilityList{"Levitate"});
+        REQUIRE(list[0].name.data() == loadPokemon(fileName)[0].name.data());
     }
     SECTION("missing field") {
-        const string fileName = "data/test_pokemon_invalid.json";
+        const string fileName = "test_pokemon_invalid.json";
         const string testJson = R"([
             {
                 "name": "Bulbasaur",
                 "primaryType": "Grass",
-                // missing abilities field
+                "abilities": ["Overgrow"]
+            },
+            {
+                "name": "Ivysaur",
+                "primaryType": "Grass"
             }
         ])";
         {
@@ -85,6 +108,70 @@ TEST_CASE("loadPokemon") {
         }
 
         REQUIRE_THROWS_AS(loadPokemon(fileName), std::runtime_error);
+        // Reported against the record that lacks it, at the line the record starts on
+        const string message = loadError(fileName);
+        REQUIRE(message.find("record 2") != string::npos);
+        REQUIRE(message.find("line 7") != string::npos);
+        REQUIRE(message.find("\"abilities\"") != string::npos);
+    }
+    SECTION("invalid values name the record and line") {
+        const string fileName = "test_pokemon_bad_values.json";
+        {
+            std::ofstream outFile(fileName);
+            outFile << R"([
+                {"name": "Bulbasaur", "primaryType": "Grass", "abilities": ["Overgrow"]},
+                {"name": "Missingno",
+                 "primaryType": "Bird",
+                 "abilities": []}
+            ])";
+        }
+        string message = loadError(fileName);
+        REQUIRE(message.find("record 2") != string::npos);
+        REQUIRE(message.find("line 4") != string::npos);
+        REQUIRE(message.find("Bird") != string::npos);
+
+        {
+            std::ofstream outFile(fileName);
+            outFile << R"([{"name": "Bulbasaur", "primaryType": "Grass", "abilities": ["Overgrow", 3]}])";
+        }
+        message = loadError(fileName);
+        REQUIRE(message.find("record 1") != string::npos);
+        REQUIRE(message.find("abilities") != string::npos);
+
+        {
+            std::ofstream outFile(fileName);
+            outFile << R"([{"name": "Bulbasaur", "primaryType": "Grass", "abilities": ["A", "B", "C", "D", "E"]}])";
+        }
+        REQUIRE(loadError(fileName).find("abilities") != string::npos);
+
+        {
+            std::ofstream outFile(fileName);
+            outFile << R"({"name": "Bulbasaur", "primaryType": "Grass", "abilities": ["Overgrow"]})";
+        }
+        REQUIRE_THROWS_AS(loadPokemon(fileName), std::runtime_error);
+    }
+    SECTION("unknown keys are skipped") {
+        const string fileName = "test_pokemon_extra_keys.json";
+        {
+            std::ofstream outFile(fileName);
+            outFile << R"([
+                {
+                    "dexNumber": 1,
+                    "name": "Bulbasaur",
+                    "stats": {"hp": 45, "moves": [["Tackle", 40], {"name": "Growl"}]},
+                    "primaryType": "Grass",
+                    "secondaryType": null,
+                    "abilities": ["Overgrow"],
+                    "forms": []
+                }
+            ])";
+        }
+        const PokemonList list = loadPokemon(fileName);
+        REQUIRE(list.size() == 1);
+        REQUIRE(list[0].name == "Bulbasaur");
+        REQUIRE(list[0].primaryType == Type::Grass);
+        REQUIRE(!list[0].secondaryType.has_value());
+        REQUIRE(list[0].abilities == AbilityList{"Overgrow"});
     }
     SECTION("malformed json") {
         const string fileName = "test_pokemon_malformed.json";
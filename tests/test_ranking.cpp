@@ -0,0 +1,200 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+#include "ranking.h"
+
+namespace {
+    TeamIndices teamOf(std::initializer_list<size_t> indices) {
+        TeamIndices team;
+        for (const auto index : indices) team.push_back(index);
+        return team;
+    }
+
+    // The ranking RankKey packs: combined score, offense, defense, then greater member indices
+    bool ranksAbove(const ScoredTeam& a, const ScoredTeam& b) {
+        const double combinedA = StandardRanking::combine(a.offensiveScore, a.defensiveScore);
+        const double combinedB = StandardRanking::combine(b.offensiveScore, b.defensiveScore);
+        if (combinedA != combinedB) return combinedA > combinedB;
+        if (a.offensiveScore != b.offensiveScore) return a.offensiveScore > b.offensiveScore;
+        if (a.defensiveScore != b.defensiveScore) return a.defensiveScore > b.defensiveScore;
+        return b.members < a.members;
+    }
+}
+
+TEST_CASE("RankKey") {
+    SECTION("Decodes to the scores and members it was built from") {
+        const TeamIndices members = teamOf({0, 3, 3, 17, 400, 65534});
+        const RankKey key(StandardRanking{}, 231.0, -2.75, members);
+        REQUIRE(key.offensiveScore() == 231.0);
+        REQUIRE(key.defensiveScore() == -2.75);
+        REQUIRE(key.combinedScore() == StandardRanking::combine(231.0, -2.75));
+        REQUIRE(key.members().size() == members.size());
+        REQUIRE(std::equal(members.begin(), members.end(), key.members().begin()));
+    }
+    SECTION("Orders like the scores, then the member indices") {
+        std::mt19937 random(7);
+        std::uniform_int_distribution<int> offense(0, 6);
+        std::uniform_int_distribution<int> defense(-8, 8);
+        std::uniform_int_distribution<size_t> member(0, 5);
+        std::vector<ScoredTeam> teams;
+        for (size_t i = 0; i < 300; ++i) {
+            TeamIndices members;
+            for (size_t slot = 0; slot < 3; ++slot) members.push_back(member(random));
+            members.sort();
+            teams.push_back(ScoredTeam{Team{}, double(offense(random)), defense(random) / 4.0, members});
+        }
+        for (const auto& a : teams) {
+            for (const auto& b : teams) {
+                const RankKey keyA(StandardRanking{}, a.offensiveScore, a.defensiveScore, a.members);
+                const RankKey keyB(StandardRanking{}, b.offensiveScore, b.defensiveScore, b.members);
+                REQUIRE((keyA > keyB) == ranksAbove(a, b));
+            }
+        }
+        REQUIRE(RankKey(StandardRanking{}, 1.0, 0.0, teamOf({1, 2})) > RankKey(StandardRanking{}, 1.0, -0.0, teamOf({1})));
+    }
+    SECTION("The best key for a score ranks above every team with that score") {
+        const RankKey best = RankKey::bestWithScores(StandardRanking{}, 10.0, 1.0);
+        REQUIRE(best > RankKey(StandardRanking{}, 10.0, 1.0, teamOf({65534, 65534, 65534, 65534, 65534, 65534})));
+        REQUIRE(best < RankKey(StandardRanking{}, 10.0, 1.25, teamOf({0})));
+    }
+    SECTION("A runtime policy ranks like the fixed ranking with the same weights") {
+        const RankingPolicy policy{1.0, 4.0};
+        REQUIRE(policy == StandardRanking::policy);
+        REQUIRE(RankKey(policy, 231.0, -2.75, teamOf({1})) == RankKey(StandardRanking{}, 231.0, -2.75, teamOf({1})));
+        REQUIRE(RankKey(policy, 3.0, 1.0, teamOf({1})).withMembers(teamOf({2, 5})) == RankKey(policy, 3.0, 1.0, teamOf({2, 5})));
+    }
+}
+
+TEST_CASE("RankingPolicy") {
+    REQUIRE(RankingPolicy{}.combine(10.0, 0.5) == 12.0);
+    REQUIRE(BalancedRanking::combine(10.0, 0.5) == 10.5);
+    REQUIRE(OffenseRanking::combine(10.0, 0.5) == 10.0);
+    REQUIRE(RankingPolicy{2.0, 3.0}.valid());
+    REQUIRE(!RankingPolicy{-1.0, 1.0}.valid());
+    REQUIRE(!RankingPolicy{1.0, std::numeric_limits<double>::infinity()}.valid());
+    // Fixed weightings dispatch to their compile-time ranking, others run on the policy
+    REQUIRE(withRanking(RankingPolicy{1.0, 1.0}, [](const auto& ranking) {
+        return std::is_same_v<std::decay_t<decltype(ranking)>, BalancedRanking>;
+    }));
+    REQUIRE(withRanking(RankingPolicy{2.0, 3.0}, [](const auto& ranking) {
+        return std::is_same_v<std::decay_t<decltype(ranking)>, RankingPolicy>;
+    }));
+}
+
+TEST_CASE("TopTeams") {
+    std::mt19937 random(11);
+    std::uniform_int_distribution<int> score(0, 20);
+    std::vector<RankKey> keys;
+    for (size_t i = 0; i < 500; ++i) {
+        // Few distinct scores, so most offers tie and are decided by the members
+        keys.emplace_back(StandardRanking{}, double(score(random) % 5), 0.25 * (score(random) % 3), teamOf({i / 100, i % 100}));
+    }
+    std::vector<RankKey> expected = keys;
+    std::sort(expected.begin(), expected.end(), [](const RankKey& a, const RankKey& b) { return a > b; });
+    expected.resize(25);
+
+    auto requireTop = [&expected](const TopTeams& top) {
+        const std::vector<ScoredTeam> results = top.results();
+        REQUIRE(results.size() == expected.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            REQUIRE(RankKey(StandardRanking{}, results[i].offensiveScore, results[i].defensiveScore, results[i].members) == expected[i]);
+        }
+    };
+
+    SECTION("Keeps the best teams whatever the offer order") {
+        TopTeams top(25);
+        for (const auto& key : keys) top.offer(key);
+        requireTop(top);
+        REQUIRE(top.full());
+        REQUIRE(top.worst() == expected.back());
+        REQUIRE(!top.accepts(expected.back()));
+        REQUIRE(!top.couldAccept(StandardRanking{}, 0.0, 0.0));
+
+        std::shuffle(keys.begin(), keys.end(), random);
+        TopTeams shuffled(25);
+        for (const auto& key : keys) shuffled.offer(key);
+        requireTop(shuffled);
+    }
+    SECTION("Merged per-worker instances keep the same teams") {
+        std::vector<TopTeams> workers(4, TopTeams(25));
+        for (size_t i = 0; i < keys.size(); ++i) workers[i % workers.size()].offer(keys[i]);
+        TopTeams merged(25);
+        for (const auto& worker : workers) merged.merge(worker);
+        requireTop(merged);
+    }
+    SECTION("Zero capacity keeps nothing") {
+        TopTeams top(0);
+        REQUIRE(!top.offer(keys[0]));
+        REQUIRE(top.results().empty());
+    }
+}
+
+TEST_CASE("ParetoFrontier") {
+    std::mt19937 random(5);
+    std::uniform_int_distribution<int> score(0, 12);
+    std::vector<RankKey> keys;
+    for (size_t i = 0; i < 400; ++i) {
+        // Few distinct points, so many offers tie with a kept team
+        keys.emplace_back(StandardRanking{}, double(score(random)), 0.5 * (score(random) % 7), teamOf({i / 50, i % 50}));
+    }
+    // Brute force: the keys nothing beats on both scores, the highest-ranked one per point
+    std::vector<RankKey> expected;
+    for (const auto& key : keys) {
+        bool kept = true;
+        for (const auto& other : keys) {
+            const bool atLeast = other.offensiveScore() >= key.offensiveScore() && other.defensiveScore() >= key.defensiveScore();
+            const bool samePoint = other.offensiveScore() == key.offensiveScore() && other.defensiveScore() == key.defensiveScore();
+            if (atLeast && (!samePoint || other > key)) kept = false;
+        }
+        if (kept) expected.push_back(key);
+    }
+    std::sort(expected.begin(), expected.end(), [](const RankKey& a, const RankKey& b) { return a.offensiveScore() > b.offensiveScore(); });
+
+    auto requireFrontier = [&expected](const ParetoFrontier& frontier) {
+        const std::vector<ScoredTeam> results = frontier.results();
+        REQUIRE(results.size() == expected.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            REQUIRE(RankKey(StandardRanking{}, results[i].offensiveScore, results[i].defensiveScore, results[i].members) == expected[i]);
+        }
+    };
+
+    SECTION("Keeps the undominated teams whatever the offer order") {
+        ParetoFrontier frontier;
+        for (const auto& key : keys) frontier.offer(key);
+        requireFrontier(frontier);
+        for (const auto& key : expected) {
+            REQUIRE(!frontier.dominated(key.offensiveScore(), key.defensiveScore()));
+            REQUIRE(frontier.dominated(key.offensiveScore() - 1.0, key.defensiveScore()));
+            REQUIRE(!frontier.offer(key));
+        }
+
+        std::shuffle(keys.begin(), keys.end(), random);
+        ParetoFrontier shuffled;
+        for (const auto& key : keys) shuffled.offer(key);
+        requireFrontier(shuffled);
+    }
+    SECTION("Merged per-worker instances keep the same teams") {
+        std::vector<ParetoFrontier> workers(3);
+        for (size_t i = 0; i < keys.size(); ++i) workers[i % workers.size()].offer(keys[i]);
+        ParetoFrontier merged;
+        for (const auto& worker : workers) merged.merge(worker);
+        requireFrontier(merged);
+    }
+    SECTION("Ranking the frontier puts each weighting's best team first") {
+        ParetoFrontier frontier;
+        for (const auto& key : keys) frontier.offer(key);
+        for (const RankingPolicy ranking : {StandardRanking::policy, BalancedRanking::policy, OffenseRanking::policy, RankingPolicy{0.0, 1.0}}) {
+            RankKey best = keys.front();
+            for (const auto& key : keys) {
+                const RankKey ranked(ranking, key.offensiveScore(), key.defensiveScore(), key.members());
+                if (ranked > RankKey(ranking, best.offensiveScore(), best.defensiveScore(), best.members())) best = key;
+            }
+            const std::vector<ScoredTeam> ranked = rankFrontier(frontier.results(), ranking);
+            REQUIRE(ranked.size() == expected.size());
+            REQUIRE(RankKey(StandardRanking{}, ranked.front().offensiveScore, ranked.front().defensiveScore, ranked.front().members) == best);
+        }
+    }
+}
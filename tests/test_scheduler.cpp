@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "scheduler.h"
+
+TEST_CASE("WorkStealingScheduler") {
+    SECTION("Runs submitted and spawned tasks exactly once") {
+        WorkStealingScheduler scheduler(4);
+        std::vector<std::atomic<int>> runs(64);
+        for (auto& r : runs) r = 0;
+
+        for (size_t root = 0; root < 8; ++root) {
+            scheduler.submit([&scheduler, &runs, root](size_t worker) {
+                ++runs[root * 8];
+                for (size_t child = 1; child < 8; ++child) {
+                    scheduler.spawn(worker, [&runs, root, child](size_t) { ++runs[root * 8 + child]; });
+                }
+            });
+        }
+        scheduler.run();
+
+        for (const auto& r : runs) REQUIRE(r == 1);
+        REQUIRE(scheduler.stats().workers.size() == 4);
+        REQUIRE(scheduler.stats().totalTasks() == 64);
+    }
+    SECTION("Zero workers falls back to one") {
+        WorkStealingScheduler scheduler(0);
+        int ran = 0;
+        scheduler.submit([&ran](size_t worker) { ran += 1 + static_cast<int>(worker); });
+        scheduler.run();
+        REQUIRE(scheduler.workerCount() == 1);
+        REQUIRE(ran == 1);
+        REQUIRE(scheduler.stats().totalSteals() == 0);
+    }
+    SECTION("Tasks queued when a task throws are dropped and run rethrows") {
+        // One worker: the children sit on its deque when their parent throws
+        WorkStealingScheduler scheduler(1);
+        std::atomic<int> ran{0};
+        scheduler.submit([&scheduler, &ran](size_t worker) {
+            for (size_t child = 0; child < 8; ++child) scheduler.spawn(worker, [&ran](size_t) { ++ran; });
+            throw std::runtime_error("task failed");
+        });
+        REQUIRE_THROWS_AS(scheduler.run(), std::runtime_error);
+        REQUIRE(ran == 0);
+        REQUIRE(scheduler.stats().totalTasks() == 0);
+    }
+    SECTION("The last task throwing wakes the parked workers") {
+        WorkStealingScheduler scheduler(4);
+        std::atomic<int> ran{0};
+        scheduler.submit([&ran](size_t) {
+            // Long enough for the other workers to find nothing and park
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            ++ran;
+            throw std::runtime_error("task failed");
+        });
+        REQUIRE_THROWS_AS(scheduler.run(), std::runtime_error);
+        REQUIRE(ran == 1);
+        REQUIRE(scheduler.stats().totalIdleSeconds() > 0.0);
+    }
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "generator.h"
+#include "snapshot.h"
+#include "team.h"
+
+using std::string;
+using std::vector;
+
+namespace {
+    vector<char> readBytes(const string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void writeBytes(const string& path, const vector<char>& bytes) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+}
+
+TEST_CASE("Snapshot") {
+    const string fileName = "test_snapshot.snapshot";
+    const GameData json = loadGameData("coolPokemon.json", "typeChart.json", "abilityEffects.json", "type_ability_combos.json");
+    const SourceFingerprint sources = fingerprintSources("coolPokemon.json", "typeChart.json", "abilityEffects.json", "type_ability_combos.json");
+    writeSnapshot(json, sources, fileName);
+
+    SECTION("Round trip reproduces the JSON data") {
+        const GameData snapshot = loadSnapshot(fileName);
+        REQUIRE(snapshot.pokemon.size() == json.pokemon.size());
+        for (size_t i = 0; i < json.pokemon.size(); ++i) {
+            REQUIRE(snapshot.pokemon[i].name == json.pokemon[i].name);
+            REQUIRE(snapshot.pokemon[i].primaryType == json.pokemon[i].primaryType);
+            REQUIRE(snapshot.pokemon[i].secondaryType == json.pokemon[i].secondaryType);
+            REQUIRE(snapshot.pokemon[i].abilities == json.pokemon[i].abilities);
+        }
+        REQUIRE(snapshot.targets.size() == json.targets.size());
+        for (size_t i = 0; i < json.targets.size(); ++i) {
+            REQUIRE(snapshot.targets[i].primaryType == json.targets[i].primaryType);
+            REQUIRE(snapshot.targets[i].secondaryType == json.targets[i].secondaryType);
+            REQUIRE(snapshot.targets[i].abilities == json.targets[i].abilities);
+        }
+        REQUIRE(snapshot.typeChart == json.typeChart);
+        REQUIRE(snapshot.targetCoverage == json.targetCoverage);
+        for (const auto& member : json.pokemon) {
+            for (const Type attacker : TypeUtils::all()) {
+                REQUIRE(getTypeEffectiveness(snapshot.typeChart, snapshot.abilityEffects, attacker, member.primaryType, member.abilities, member.secondaryType) ==
+                    getTypeEffectiveness(json.typeChart, json.abilityEffects, attacker, member.primaryType, member.abilities, member.secondaryType));
+            }
+        }
+    }
+    SECTION("Teams generated from a snapshot match the JSON run") {
+        const GameData snapshot = loadSnapshot(fileName);
+        const TeamEvaluator jsonEvaluator(json.typeChart, json.abilityEffects, json.targets);
+        const TeamEvaluator snapshotEvaluator(snapshot.typeChart, snapshot.abilityEffects, snapshot.targets, snapshot.targetCoverage);
+        TeamGenerator fromJson(json.pokemon, jsonEvaluator, ConflictRule::TGOM_Ghost);
+        TeamGenerator fromSnapshot(snapshot.pokemon, snapshotEvaluator, ConflictRule::TGOM_Ghost);
+        const vector<ScoredTeam> expected = fromJson.generateTopTeams(4, 5);
+        const vector<ScoredTeam> teams = fromSnapshot.generateTopTeams(4, 5);
+        REQUIRE(teams.size() == expected.size());
+        for (size_t i = 0; i < teams.size(); ++i) {
+            REQUIRE(teams[i].offensiveScore == expected[i].offensiveScore);
+            REQUIRE(teams[i].defensiveScore == expected[i].defensiveScore);
+            for (size_t m = 0; m < teams[i].team.size(); ++m) REQUIRE(teams[i].team[m].name == expected[i].team[m].name);
+        }
+    }
+    SECTION("The header records the fingerprint of the JSON files") {
+        REQUIRE(snapshotSources(fileName) == sources);
+        REQUIRE(sources.sizes[0] == readBytes("coolPokemon.json").size());
+
+        // One byte changed in a copy of the type chart, same size
+        const string edited = "test_snapshot_typeChart.json";
+        vector<char> chart = readBytes("typeChart.json");
+        chart.back() = (chart.back() == ' ') ? '\n' : ' ';
+        writeBytes(edited, chart);
+        const SourceFingerprint changed = fingerprintSources("coolPokemon.json", edited, "abilityEffects.json", "type_ability_combos.json");
+        REQUIRE(changed.sizes == sources.sizes);
+        REQUIRE(changed != sources);
+        std::remove(edited.c_str());
+
+        REQUIRE_THROWS_AS(fingerprintSources("missing.json", "typeChart.json", "abilityEffects.json", "type_ability_combos.json"), std::runtime_error);
+    }
+    SECTION("Damaged or foreign files are rejected") {
+        const vector<char> bytes = readBytes(fileName);
+        const string damaged = "test_snapshot_damaged.snapshot";
+
+        writeBytes(damaged, vector<char>(bytes.begin(), bytes.begin() + bytes.size() / 2));
+        REQUIRE_THROWS_AS(loadSnapshot(damaged), std::runtime_error);
+
+        vector<char> otherVersion = bytes;
+        otherVersion[8] = static_cast<char>(kSnapshotVersion + 1); // version follows the 8-byte magic
+        writeBytes(damaged, otherVersion);
+        REQUIRE_THROWS_AS(loadSnapshot(damaged), std::runtime_error);
+
+        // An ability reference past the string table. The section table follows the 32-byte header
+        // fields, 16 bytes (offset, count) per section, and AbilityRefs is the sixth section.
+        vector<char> badReference = bytes;
+        uint64_t refsOffset = 0;
+        std::memcpy(&refsOffset, badReference.data() + 32 + 5 * 16, sizeof(refsOffset));
+        const uint32_t pastStrings = 0x7FFFFFFF;
+        std::memcpy(badReference.data() + refsOffset, &pastStrings, sizeof(pastStrings));
+        writeBytes(damaged, badReference);
+        REQUIRE_THROWS_AS(loadSnapshot(damaged), std::runtime_error);
+
+        writeBytes(damaged, vector<char>{'[', ']'});
+        REQUIRE_THROWS_AS(loadSnapshot(damaged), std::runtime_error);
+        REQUIRE_THROWS_AS(loadSnapshot("missing.snapshot"), std::runtime_error);
+        std::remove(damaged.c_str());
+    }
+
+    std::remove(fileName.c_str());
+}
@@ -1,11 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include "abilities.h"
 #include "team.h"
 #include "types.h"
 #include "pokemon.h"
 
 TEST_CASE("evaluateOffense") {
     const TypeEffectiveness typeChart = loadTypeEffectiveness("typeChart.json");
-    const TeamEvaluator evaluator(typeChart);
+    const AbilityEffects abilityEffects = loadAbilityEffects("abilityEffects.json");
+    const TeamEvaluator evaluator(typeChart, abilityEffects);
 
     SECTION("Single member, single target, super effective") {
         Team team { PokemonList{ Pokemon{
@@ -291,7 +294,8 @@ TEST_CASE("evaluateOffense") {
 
 TEST_CASE("evaluateDefense") {
     const TypeEffectiveness typeChart = loadTypeEffectiveness("typeChart.json");
-    const TeamEvaluator evaluator(typeChart);
+    const AbilityEffects abilityEffects = loadAbilityEffects("abilityEffects.json");
+    const TeamEvaluator evaluator(typeChart, abilityEffects);
 
     SECTION("One attacker, one defender, neutral") {
         Team team { PokemonList{ Pokemon{
@@ -635,3 +639,112 @@ TEST_CASE("evaluateDefense") {
         REQUIRE(score == 2.0);
     }
 }
+
+TEST_CASE("buildCoverage") {
+    const TypeEffectiveness typeChart = loadTypeEffectiveness("typeChart.json");
+    const AbilityEffects abilityEffects = loadAbilityEffects("abilityEffects.json");
+    const TeamEvaluator evaluator(typeChart, abilityEffects);
+    const TypeAbilityComboList targets = loadTypeAbilityCombos("type_ability_combos.json");
+
+    SECTION("Bits match per-target reference check") {
+        Pokemon charizard{"Charizard", Type::Fire, Type::Dragon, {"Levitate", "Blaze"}};
+        CoverageSet coverage = evaluator.buildCoverage(charizard, targets);
+        REQUIRE(coverage.size() == targets.size());
+        for (size_t t = 0; t < targets.size(); ++t) {
+            TypeAbilityComboList single{ targets[t] };
+            REQUIRE(coverage.test(t) == (evaluator.evaluateOffense(Team{ charizard }, single) == 1.0));
+        }
+    }
+    SECTION("OR of member coverage matches team offense") {
+        PokemonList members {
+            Pokemon{"Charizard", Type::Fire, Type::Dragon, {"Levitate", "Blaze"}},
+            Pokemon{"Squirtle", Type::Water, std::nullopt, {"Torrent", "Rain Dish"}},
+            Pokemon{"Misdreavus", Type::Ghost, Type::Fairy, {"Levitate"}}
+        };
+        MemberProfileTable profiles = evaluator.buildProfiles(members, targets);
+        REQUIRE(profiles.size() == members.size());
+
+        CoverageSet teamCoverage(targets.size());
+        for (const auto& profile : profiles) teamCoverage.merge(profile.coverage);
+        REQUIRE(evaluator.evaluateOffense(teamCoverage) == evaluator.evaluateOffense(members, targets));
+    }
+    SECTION("An evaluator's own targets give the per-target coverage") {
+        const TeamEvaluator withTargets(typeChart, abilityEffects, targets);
+        REQUIRE(&withTargets.targets() == &targets);
+        const PokemonList pool = loadPokemon("coolPokemon.json");
+        const MemberProfileTable profiles = withTargets.buildProfiles(pool);
+        REQUIRE(profiles.size() == pool.size());
+        for (size_t i = 0; i < pool.size(); ++i) {
+            const CoverageSet reference = evaluator.buildCoverage(pool[i], targets);
+            REQUIRE(profiles[i].coverage.size() == reference.size());
+            REQUIRE(profiles[i].coverage.countNotIn(reference) == 0);
+            REQUIRE(reference.countNotIn(profiles[i].coverage) == 0);
+        }
+        REQUIRE(evaluator.targets().empty());
+    }
+}
+
+TEST_CASE("buildDefenseProfile") {
+    const TypeEffectiveness typeChart = loadTypeEffectiveness("typeChart.json");
+    const AbilityEffects abilityEffects = loadAbilityEffects("abilityEffects.json");
+    const TeamEvaluator evaluator(typeChart, abilityEffects);
+
+    SECTION("Single member profile") {
+        Pokemon charizard{"Charizard", Type::Fire, Type::Dragon, {"Levitate", "Blaze"}};
+        DefenseProfile profile = evaluator.buildDefenseProfile(charizard);
+        REQUIRE(decodeEffectiveness(profile.effectiveness[static_cast<size_t>(Type::Rock)]) == 2.0);
+        REQUIRE(decodeEffectiveness(profile.weakness[static_cast<size_t>(Type::Rock)]) == 1.0);
+        REQUIRE(decodeEffectiveness(profile.effectiveness[static_cast<size_t>(Type::Ground)]) == 0.0);
+        REQUIRE(decodeEffectiveness(profile.weakness[static_cast<size_t>(Type::Ground)]) == 0.0);
+        REQUIRE(decodeEffectiveness(profile.effectiveness[static_cast<size_t>(Type::Grass)]) == 0.25);
+        REQUIRE(decodeEffectiveness(profile.totalWeakness) == 2.0); // Rock and Dragon
+    }
+    SECTION("Fixed-point multipliers match the double reference path") {
+        // Thick Fat halves a 0.25 resist, Dry Skin raises a Fire hit to 1.25x
+        PokemonList members {
+            Pokemon{"Mamoswine", Type::Ground, Type::Ice, {"Thick Fat"}},
+            Pokemon{"Parasect", Type::Bug, Type::Grass, {"Dry Skin"}},
+            Pokemon{"Ferrothorn", Type::Grass, Type::Steel, {"Thick Fat"}}
+        };
+        for (const auto& member : members) {
+            DefenseProfile profile = evaluator.buildDefenseProfile(member);
+            for (Type attacker : TypeUtils::all()) {
+                const double reference = getTypeEffectiveness(
+                    typeChart, abilityEffects, attacker, member.primaryType,
+                    member.abilities, member.secondaryType);
+                REQUIRE(decodeEffectiveness(profile.effectiveness[static_cast<size_t>(attacker)]) == reference);
+            }
+        }
+    }
+    SECTION("Multipliers without an exact encoding are rejected") {
+        REQUIRE(encodeEffectiveness(0.3125) == 80);
+        REQUIRE(encodeEffectiveness(5.0) == 5 * kEffectivenessScale);
+        REQUIRE_THROWS_AS(encodeEffectiveness(0.1), std::invalid_argument);
+        REQUIRE_THROWS_AS(encodeEffectiveness(-1.0), std::invalid_argument);
+        REQUIRE_THROWS_AS(encodeEffectiveness(1000.0), std::invalid_argument);
+    }
+    SECTION("Accumulated profiles match team defense") {
+        PokemonList members {
+            Pokemon{"Charizard", Type::Fire, std::nullopt, {}},
+            Pokemon{"Pidgeot", Type::Normal, Type::Flying, {}},
+            Pokemon{"Misdreavus", Type::Ghost, Type::Fairy, {"Levitate"}},
+            Pokemon{"Mamoswine", Type::Ground, Type::Ice, {"Snow Cloak", "Thick Fat"}}
+        };
+        TeamDefense teamDefense;
+        for (const auto& member : members) {
+            teamDefense.add(evaluator.buildDefenseProfile(member));
+        }
+        REQUIRE(evaluator.evaluateDefense(teamDefense) == evaluator.evaluateDefense(members, TypeUtils::all()));
+    }
+}
+
+TEST_CASE("TeamIndices") {
+    SECTION("sort orders the slots from the given position") {
+        TeamIndices team;
+        for (size_t index : {9, 4, 7, 1, 8}) team.push_back(index);
+        team.sort(1);
+        REQUIRE(std::vector<uint16_t>(team.begin(), team.end()) == std::vector<uint16_t>{9, 1, 4, 7, 8});
+        team.sort();
+        REQUIRE(std::vector<uint16_t>(team.begin(), team.end()) == std::vector<uint16_t>{1, 4, 7, 8, 9});
+    }
+}
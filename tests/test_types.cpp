@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <fstream>
 #include <string>
+#include "abilities.h"
 #include "types.h"
 
 using std::string;
@@ -65,60 +66,62 @@ TEST_CASE("getTypeEffectiveness") {
     chart[static_cast<size_t>(Type::Fire)][static_cast<size_t>(Type::Ice)] = 2.0;
     chart[static_cast<size_t>(Type::Ice)][static_cast<size_t>(Type::Grass)] = 2.0;
 
+    const AbilityEffects effects = loadAbilityEffects("abilityEffects.json");
+
     SECTION("Single-type defender, no ability") {
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Grass, {}) == 2.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Water, {}) == 0.5);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Bug, {}) == 2.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Fire, {}) == 0.5);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Grass, {}, std::nullopt) == 2.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, {}) == 2.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Water, {}) == 0.5);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Bug, {}) == 2.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Fire, {}) == 0.5);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, {}, std::nullopt) == 2.0);
     }
 
     SECTION("Dual-type defender, no ability") {
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Grass, {}, Type::Bug) == 4.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Grass, {}, Type::Water) == 1.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Water, {}, Type::Bug) == 1.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, {}, Type::Bug) == 4.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, {}, Type::Water) == 1.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Water, {}, Type::Bug) == 1.0);
     }
 
     SECTION("Single-type defender with immunity ability") {
-        vector<string> abilities = {"Flash Fire"};
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Grass, abilities) == 0.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Water, abilities) == 0.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Normal, abilities) == 0.0);
-
-        abilities = {"Levitate"};
-        REQUIRE(getTypeEffectiveness(chart, Type::Ground, Type::Fire, abilities) == 0.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Ground, Type::Bug, abilities) == 0.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Ground, Type::Normal, abilities) == 0.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Ground, Type::Flying, abilities) == 0.0);
-
-        abilities = {"Water Absorb"};
-        REQUIRE(getTypeEffectiveness(chart, Type::Water, Type::Fire, abilities) == 0.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Water, Type::Grass, abilities) == 0.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Water, Type::Normal, abilities) == 0.0);
+        AbilityList abilities = internAbilities({"Flash Fire"});
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, abilities) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Water, abilities) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Normal, abilities) == 0.0);
+
+        abilities = internAbilities({"Levitate"});
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Ground, Type::Fire, abilities) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Ground, Type::Bug, abilities) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Ground, Type::Normal, abilities) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Ground, Type::Flying, abilities) == 0.0);
+
+        abilities = internAbilities({"Water Absorb"});
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Water, Type::Fire, abilities) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Water, Type::Grass, abilities) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Water, Type::Normal, abilities) == 0.0);
     }
 
     SECTION("Single-type defender with resistance ability") {
-        vector<string> abilities = {"Thick Fat"};
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Ice, abilities) == 1.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Ice, Type::Grass, abilities) == 1.0);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Normal, abilities) == 0.5);
-        REQUIRE(getTypeEffectiveness(chart, Type::Ice, Type::Normal, abilities) == 0.5);
-
-        abilities = {"Filter"};
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Grass, abilities) == 1.5);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Ice, abilities) == 1.5);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Normal, abilities) == 1.0);
+        AbilityList abilities = internAbilities({"Thick Fat"});
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Ice, abilities) == 1.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Ice, Type::Grass, abilities) == 1.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Normal, abilities) == 0.5);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Ice, Type::Normal, abilities) == 0.5);
+
+        abilities = internAbilities({"Filter"});
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, abilities) == 1.5);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Ice, abilities) == 1.5);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Normal, abilities) == 1.0);
     }
 
     SECTION("Single-type defender with misc ability") {
-        vector<string> abilities = {"Dry Skin"};
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Normal, abilities) == 1.25);
-        REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Grass, abilities) == 2.5);
+        AbilityList abilities = internAbilities({"Dry Skin"});
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Normal, abilities) == 1.25);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, abilities) == 2.5);
     }
 
     SECTION("Single-type attacker vs Sap Sipper") {
-        vector<string> abilities = {"Sap Sipper"};
-        REQUIRE(getTypeEffectiveness(chart, Type::Grass, Type::Normal, abilities) == 0.0);
+        AbilityList abilities = internAbilities({"Sap Sipper"});
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Grass, Type::Normal, abilities) == 0.0);
     }
 }
 
@@ -145,11 +148,57 @@ TEST_CASE("loadTypeEffectiveness") {
     }
 
     TypeEffectiveness chart = loadTypeEffectiveness(fileName);
+    const AbilityEffects effects;
+
+    REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, {}) == 2.0);
+    REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Water, {}) == 0.5);
+    REQUIRE(getTypeEffectiveness(chart, effects, Type::Water, Type::Fire, {}) == 2.0);
+    REQUIRE(getTypeEffectiveness(chart, effects, Type::Water, Type::Grass, {}) == 0.5);
+    REQUIRE(getTypeEffectiveness(chart, effects, Type::Grass, Type::Water, {}) == 2.0);
+    REQUIRE(getTypeEffectiveness(chart, effects, Type::Grass, Type::Fire, {}) == 0.5);
+}
+TEST_CASE("loadAbilityEffects") {
+    TypeEffectiveness chart = {};
+    for (size_t i = 0; i < NUM_TYPES; ++i)
+        for (size_t j = 0; j < NUM_TYPES; ++j)
+            chart[i][j] = 1.0;
+    chart[static_cast<size_t>(Type::Water)][static_cast<size_t>(Type::Fire)] = 2.0;
+    chart[static_cast<size_t>(Type::Fire)][static_cast<size_t>(Type::Grass)] = 2.0;
 
-    REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Grass, {}) == 2.0);
-    REQUIRE(getTypeEffectiveness(chart, Type::Fire, Type::Water, {}) == 0.5);
-    REQUIRE(getTypeEffectiveness(chart, Type::Water, Type::Fire, {}) == 2.0);
-    REQUIRE(getTypeEffectiveness(chart, Type::Water, Type::Grass, {}) == 0.5);
-    REQUIRE(getTypeEffectiveness(chart, Type::Grass, Type::Water, {}) == 2.0);
-    REQUIRE(getTypeEffectiveness(chart, Type::Grass, Type::Fire, {}) == 0.5);
-}
\ No newline at end of file
+    SECTION("Effects come from the file") {
+        const string fileName = "test_ability_effects.json";
+        {
+            std::ofstream out(fileName);
+            out << R"({
+                "Storm Drain": { "immuneTo": ["Water"] },
+                "Wonder Guard": { "immuneUnlessSuperEffective": true },
+                "Fluffy": { "multipliers": { "Fire": 2.0 } },
+                "Prism Armor": { "superEffectiveMultiplier": 0.75 }
+            })";
+        }
+        const AbilityEffects effects = loadAbilityEffects(fileName);
+
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Water, Type::Fire, internAbilities({"Storm Drain"})) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Water, Type::Fire, internAbilities({"Wonder Guard"})) == 2.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Normal, internAbilities({"Wonder Guard"})) == 0.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Normal, internAbilities({"Fluffy"})) == 2.0);
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Grass, internAbilities({"Prism Armor"})) == 1.5);
+        // Names match exactly and abilities without an entry do nothing
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Water, Type::Fire, internAbilities({"Storm drain"})) == 2.0);
+        // Any immunity beats a modifier listed earlier
+        REQUIRE(getTypeEffectiveness(chart, effects, Type::Fire, Type::Normal, internAbilities({"Fluffy", "Wonder Guard"})) == 0.0);
+    }
+    SECTION("Unknown types are rejected") {
+        const string fileName = "test_ability_effects_invalid.json";
+        {
+            std::ofstream out(fileName);
+            out << R"({ "Levitate": { "immuneTo": ["Sound"] } })";
+        }
+        REQUIRE_THROWS_AS(loadAbilityEffects(fileName), std::runtime_error);
+    }
+    SECTION("Interned IDs are stable") {
+        REQUIRE(internAbility("Levitate") == internAbility("Levitate"));
+        REQUIRE(internAbility("Levitate") != internAbility("levitate"));
+        REQUIRE(abilityName(internAbility("Thick Fat")) == "Thick Fat");
+    }
+}